@@ -0,0 +1,248 @@
+// Phase-level benchmark harness for the native compiler.
+//
+// Exercises lexer::tokenize, parser::parse, and both generators separately
+// over a corpus: any .trif files passed on the command line plus a synthetic
+// large module (with no files, the synthetic module is the whole corpus).
+// Reports throughput per phase and peak RSS so lexer and parser changes can
+// be accepted or rejected on numbers.
+//
+// Build with `./build.sh bench`, run as:
+//   trif-bench [--iterations N] [--synthetic-lines N] [file.trif ...]
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "trif/ast.hpp"
+#include "trif/codegen.hpp"
+#include "trif/lexer.hpp"
+#include "trif/parser.hpp"
+
+namespace {
+
+struct CorpusEntry {
+    std::string name;
+    std::string source;
+};
+
+std::string load_file(const std::string& path) {
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        throw std::runtime_error("Unable to open corpus file: " + path);
+    }
+    std::ostringstream buffer;
+    buffer << stream.rdbuf();
+    return buffer.str();
+}
+
+// Machine-written module in the style of our generated inputs: many small
+// functions over literal-heavy expressions.
+std::string synthesize_module(int line_target) {
+    std::ostringstream source;
+    int emitted = 0;
+    int index = 0;
+    while (emitted < line_target) {
+        source << "fn generated_" << index << "(a, b, c) {\n";
+        source << "    let total = a * 2 + b * 3 + c * " << (index % 17) << "\n";
+        source << "    let table = {\"low\": [1, 2, 3], \"high\": [4, 5, 6, " << index << "]}\n";
+        source << "    if total > " << (index % 97) << " && total != 0 {\n";
+        source << "        return total % 13\n";
+        source << "    } else {\n";
+        source << "        return table.low\n";
+        source << "    }\n";
+        source << "}\n";
+        emitted += 8;
+        ++index;
+    }
+    return source.str();
+}
+
+std::size_t count_nodes(trif::ast::NodePtr node);
+
+std::size_t count_body(const std::vector<trif::ast::NodePtr>& body) {
+    std::size_t count = 0;
+    for (const auto& stmt : body) {
+        count += count_nodes(stmt);
+    }
+    return count;
+}
+
+std::size_t count_nodes(trif::ast::NodePtr node) {
+    using namespace trif::ast;
+    std::size_t count = 1;
+    switch (node->kind) {
+        case NodeKind::Module:
+            count += count_body(static_cast<Module*>(node)->body);
+            break;
+        case NodeKind::Let:
+            count += count_nodes(static_cast<Let*>(node)->value);
+            break;
+        case NodeKind::Assign: {
+            auto* assign = static_cast<Assign*>(node);
+            count += count_nodes(assign->target) + count_nodes(assign->value);
+            break;
+        }
+        case NodeKind::FunctionDef:
+            count += count_body(static_cast<FunctionDef*>(node)->body);
+            break;
+        case NodeKind::ExportDefault:
+            count += count_nodes(static_cast<ExportDefault*>(node)->value);
+            break;
+        case NodeKind::Return: {
+            auto* ret = static_cast<Return*>(node);
+            if (ret->value) {
+                count += count_nodes(*ret->value);
+            }
+            break;
+        }
+        case NodeKind::If: {
+            auto* branch = static_cast<If*>(node);
+            count += count_nodes(branch->test) + count_body(branch->body) + count_body(branch->orelse);
+            break;
+        }
+        case NodeKind::While: {
+            auto* loop = static_cast<While*>(node);
+            count += count_nodes(loop->test) + count_body(loop->body);
+            break;
+        }
+        case NodeKind::For: {
+            auto* loop = static_cast<For*>(node);
+            count += count_nodes(loop->iterator) + count_body(loop->body);
+            break;
+        }
+        case NodeKind::Spawn:
+            count += count_nodes(static_cast<Spawn*>(node)->call);
+            break;
+        case NodeKind::BinaryOp: {
+            auto* op = static_cast<BinaryOp*>(node);
+            count += count_nodes(op->left) + count_nodes(op->right);
+            break;
+        }
+        case NodeKind::UnaryOp:
+            count += count_nodes(static_cast<UnaryOp*>(node)->operand);
+            break;
+        case NodeKind::Call: {
+            auto* call = static_cast<Call*>(node);
+            count += count_nodes(call->func);
+            for (const auto& arg : call->args) {
+                count += count_nodes(arg);
+            }
+            break;
+        }
+        case NodeKind::Attribute:
+            count += count_nodes(static_cast<Attribute*>(node)->value);
+            break;
+        case NodeKind::ListLiteral:
+            for (const auto& element : static_cast<ListLiteral*>(node)->elements) {
+                count += count_nodes(element);
+            }
+            break;
+        case NodeKind::DictLiteral:
+            for (const auto& [key, value] : static_cast<DictLiteral*>(node)->pairs) {
+                count += count_nodes(key) + count_nodes(value);
+            }
+            break;
+        default:
+            break;
+    }
+    return count;
+}
+
+long peak_rss_kb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void report(const std::string& phase, double seconds, std::size_t items, const char* unit) {
+    std::cout << "  " << std::left << std::setw(12) << phase << std::right << std::fixed
+              << std::setprecision(3) << std::setw(9) << seconds * 1000.0 << " ms  " << std::setw(12)
+              << static_cast<long long>(items / seconds) << ' ' << unit << "/s  peak rss "
+              << peak_rss_kb() << " KB" << std::endl;
+}
+
+void run_entry(const CorpusEntry& entry, int iterations) {
+    std::cout << entry.name << " (" << entry.source.size() << " bytes, " << iterations
+              << " iterations)" << std::endl;
+
+    trif::lexer::TokenStream tokens;
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        tokens = trif::lexer::tokenize(entry.source);
+    }
+    report("lex", seconds_since(start), tokens.size() * iterations, "tokens");
+
+    std::vector<std::unique_ptr<trif::ast::Arena>> arenas;
+    trif::ast::ModulePtr module = nullptr;
+    start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        arenas.push_back(std::make_unique<trif::ast::Arena>());
+        module = trif::parser::parse(entry.source, tokens, *arenas.back());
+    }
+    std::size_t nodes = count_nodes(module);
+    report("parse", seconds_since(start), nodes * iterations, "nodes");
+    auto owner = std::move(arenas.back());  // keep only the arena owning `module`
+    arenas.clear();
+
+    std::string output;
+    start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        trif::codegen::PythonGenerator generator;
+        output = generator.generate(module);
+    }
+    report("codegen-py", seconds_since(start), output.size() * iterations, "bytes");
+
+    start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        trif::codegen::JavaScriptGenerator generator;
+        output = generator.generate(module);
+    }
+    report("codegen-js", seconds_since(start), output.size() * iterations, "bytes");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int iterations = 20;
+    int synthetic_lines = 40000;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        std::string value = argv[i];
+        if (value == "--iterations" && i + 1 < argc) {
+            iterations = std::stoi(argv[++i]);
+        } else if (value == "--synthetic-lines" && i + 1 < argc) {
+            synthetic_lines = std::stoi(argv[++i]);
+        } else {
+            files.push_back(value);
+        }
+    }
+    try {
+        std::vector<CorpusEntry> corpus;
+        for (const auto& file : files) {
+            corpus.push_back({file, load_file(file)});
+        }
+        if (synthetic_lines > 0) {
+            corpus.push_back({"synthetic-" + std::to_string(synthetic_lines) + "-lines",
+                              synthesize_module(synthetic_lines)});
+        }
+        for (const auto& entry : corpus) {
+            run_entry(entry, iterations);
+        }
+    } catch (const std::exception& exc) {
+        std::cerr << "trif-bench: " << exc.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
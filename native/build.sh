@@ -2,23 +2,66 @@
 set -euo pipefail
 
 CXX=${CXX:-g++}
-CXXFLAGS=("-std=c++20" "-O3" "-Wall" "-Wextra" "-Werror" "-DNDEBUG")
+CXXFLAGS=("-std=c++20" "-O3" "-Wall" "-Wextra" "-Werror" "-DNDEBUG" "-pthread")
 SRC_DIR="$(cd "$(dirname "$0")" && pwd)/src"
 BUILD_DIR="${BUILD_DIR:-$SRC_DIR/../build}"
 mkdir -p "$BUILD_DIR"
 
 sources=(
+  "$SRC_DIR/interner.cpp"
   "$SRC_DIR/lexer.cpp"
   "$SRC_DIR/parser.cpp"
+  "$SRC_DIR/astio.cpp"
+  "$SRC_DIR/opt.cpp"
   "$SRC_DIR/codegen.cpp"
   "$SRC_DIR/compiler.cpp"
+  "$SRC_DIR/daemon.cpp"
+  "$SRC_DIR/lsp.cpp"
+  "$SRC_DIR/watch.cpp"
+  "$SRC_DIR/graph.cpp"
   "$SRC_DIR/main.cpp"
 )
 
 includes=("-I$SRC_DIR/../include")
 
-output="$BUILD_DIR/trifc"
+target="${1:-trifc}"
 
-echo "[trif-build] Compiling ${#sources[@]} translation units..."
-"$CXX" "${CXXFLAGS[@]}" "${includes[@]}" "${sources[@]}" -o "$output"
+case "$target" in
+  trifc)
+    output="$BUILD_DIR/trifc"
+    echo "[trif-build] Compiling ${#sources[@]} translation units..."
+    "$CXX" "${CXXFLAGS[@]}" "${includes[@]}" "${sources[@]}" -o "$output"
+    ;;
+  bench)
+    bench_sources=(
+      "$SRC_DIR/interner.cpp"
+      "$SRC_DIR/lexer.cpp"
+      "$SRC_DIR/parser.cpp"
+      "$SRC_DIR/codegen.cpp"
+      "$SRC_DIR/../bench/bench_main.cpp"
+    )
+    output="$BUILD_DIR/trif-bench"
+    echo "[trif-build] Compiling ${#bench_sources[@]} translation units (bench)..."
+    "$CXX" "${CXXFLAGS[@]}" "${includes[@]}" "${bench_sources[@]}" -o "$output"
+    ;;
+  libtrifc)
+    lib_sources=(
+      "$SRC_DIR/interner.cpp"
+      "$SRC_DIR/lexer.cpp"
+      "$SRC_DIR/parser.cpp"
+      "$SRC_DIR/astio.cpp"
+      "$SRC_DIR/opt.cpp"
+      "$SRC_DIR/codegen.cpp"
+      "$SRC_DIR/compiler.cpp"
+      "$SRC_DIR/capi.cpp"
+    )
+    output="$BUILD_DIR/libtrifc.so"
+    echo "[trif-build] Compiling ${#lib_sources[@]} translation units (libtrifc)..."
+    "$CXX" "${CXXFLAGS[@]}" -fPIC -shared "${includes[@]}" "${lib_sources[@]}" -o "$output"
+    ;;
+  *)
+    echo "[trif-build] Unknown target: $target (expected trifc, bench, or libtrifc)" >&2
+    exit 1
+    ;;
+esac
 echo "[trif-build] Output -> $output"
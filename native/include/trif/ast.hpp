@@ -1,14 +1,23 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <memory>
+#include <new>
 #include <optional>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <variant>
 #include <vector>
 
+#include "interner.hpp"
+
 namespace trif::ast {
 
+// Statement kinds come first; every kind from Name onward is an Expression
+// subclass. is_expression_kind and the visitor dispatch rely on that
+// grouping, so new expression kinds belong at the end.
 enum class NodeKind {
     Module,
     ImportFrom,
@@ -42,19 +51,92 @@ struct Node {
     NodeKind kind;
 };
 
-using NodePtr = std::shared_ptr<Node>;
+using NodePtr = Node*;
 
 struct Expression : Node {
     explicit Expression(NodeKind kind) : Node(kind) {}
 };
 
-using ExpressionPtr = std::shared_ptr<Expression>;
+using ExpressionPtr = Expression*;
+
+constexpr bool is_expression_kind(NodeKind kind) {
+    return kind >= NodeKind::Name;
+}
+
+// Bump allocator owning every node of one module. Nodes are handed out as raw
+// pointers valid for the arena's lifetime; releasing the arena (when the
+// CompileResult is dropped) frees the whole tree at once.
+class Arena {
+   public:
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    ~Arena() {
+        for (auto it = destructors_.rbegin(); it != destructors_.rend(); ++it) {
+            it->destroy(it->object);
+        }
+    }
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        void* memory = allocate(sizeof(T), alignof(T));
+        T* object = new (memory) T(std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            destructors_.push_back({object, [](void* p) { static_cast<T*>(p)->~T(); }});
+        }
+        ++allocations_;
+        return object;
+    }
+
+    // Objects created so far; --time-report quotes this as the node count.
+    std::size_t allocations() const { return allocations_; }
+
+   private:
+    struct Destructor {
+        void* object;
+        void (*destroy)(void*);
+    };
+
+    static constexpr std::size_t kChunkSize = 64 * 1024;
+
+    void* allocate(std::size_t size, std::size_t align) {
+        std::size_t aligned = (offset_ + align - 1) & ~(align - 1);
+        if (aligned + size > capacity_) {
+            std::size_t chunk_size = std::max(kChunkSize, size + align);
+            chunks_.push_back(std::make_unique<std::byte[]>(chunk_size));
+            offset_ = 0;
+            capacity_ = chunk_size;
+            aligned = 0;
+        }
+        void* memory = chunks_.back().get() + aligned;
+        offset_ = aligned + size;
+        return memory;
+    }
+
+    std::vector<std::unique_ptr<std::byte[]>> chunks_;
+    std::size_t offset_ = 0;
+    std::size_t capacity_ = 0;
+    std::size_t allocations_ = 0;
+    std::vector<Destructor> destructors_;
+};
+
+// Byte range [begin, end) of one top-level statement in the original source.
+struct SourceSpan {
+    std::size_t begin = 0;
+    std::size_t end = 0;
+};
 
 struct Module : Node {
     Module() : Node(NodeKind::Module) {}
     std::vector<NodePtr> body;
+    // Parallel to `body`, recorded by the parser for top-level statements.
+    // Spans tile the source — each ends where the next statement's first
+    // token begins — so watch mode can map an edited byte range to the
+    // declarations it touches. Empty for deserialized .trifb modules.
+    std::vector<SourceSpan> body_spans;
 };
-using ModulePtr = std::shared_ptr<Module>;
+using ModulePtr = Module*;
 
 struct ImportFrom : Node {
     ImportFrom() : Node(NodeKind::ImportFrom) {}
@@ -72,7 +154,15 @@ struct Import : Node {
 
 struct Let : Node {
     Let() : Node(NodeKind::Let) {}
-    std::string name;
+    Let(intern::Symbol name, ExpressionPtr value, bool mutable_flag, bool exported,
+        bool is_default)
+        : Node(NodeKind::Let),
+          name(name),
+          value(value),
+          mutable_flag(mutable_flag),
+          exported(exported),
+          is_default(is_default) {}
+    intern::Symbol name;
     ExpressionPtr value;
     bool mutable_flag = true;
     bool exported = false;
@@ -81,14 +171,24 @@ struct Let : Node {
 
 struct Assign : Node {
     Assign() : Node(NodeKind::Assign) {}
+    Assign(ExpressionPtr target, ExpressionPtr value)
+        : Node(NodeKind::Assign), target(target), value(value) {}
     ExpressionPtr target;
     ExpressionPtr value;
 };
 
 struct FunctionDef : Node {
     FunctionDef() : Node(NodeKind::FunctionDef) {}
-    std::string name;
-    std::vector<std::string> params;
+    FunctionDef(intern::Symbol name, std::vector<intern::Symbol> params,
+                std::vector<NodePtr> body, bool exported, bool is_default)
+        : Node(NodeKind::FunctionDef),
+          name(name),
+          params(std::move(params)),
+          body(std::move(body)),
+          exported(exported),
+          is_default(is_default) {}
+    intern::Symbol name;
+    std::vector<intern::Symbol> params;
     std::vector<NodePtr> body;
     bool exported = false;
     bool is_default = false;
@@ -102,16 +202,21 @@ struct ExportNames : Node {
 
 struct ExportDefault : Node {
     ExportDefault() : Node(NodeKind::ExportDefault) {}
+    explicit ExportDefault(ExpressionPtr value) : Node(NodeKind::ExportDefault), value(value) {}
     ExpressionPtr value;
 };
 
 struct Return : Node {
     Return() : Node(NodeKind::Return) {}
+    explicit Return(std::optional<ExpressionPtr> value)
+        : Node(NodeKind::Return), value(value) {}
     std::optional<ExpressionPtr> value;
 };
 
 struct If : Node {
     If() : Node(NodeKind::If) {}
+    If(ExpressionPtr test, std::vector<NodePtr> body, std::vector<NodePtr> orelse)
+        : Node(NodeKind::If), test(test), body(std::move(body)), orelse(std::move(orelse)) {}
     ExpressionPtr test;
     std::vector<NodePtr> body;
     std::vector<NodePtr> orelse;
@@ -119,39 +224,48 @@ struct If : Node {
 
 struct While : Node {
     While() : Node(NodeKind::While) {}
+    While(ExpressionPtr test, std::vector<NodePtr> body)
+        : Node(NodeKind::While), test(test), body(std::move(body)) {}
     ExpressionPtr test;
     std::vector<NodePtr> body;
 };
 
 struct For : Node {
     For() : Node(NodeKind::For) {}
-    std::string target;
+    For(intern::Symbol target, ExpressionPtr iterator, std::vector<NodePtr> body)
+        : Node(NodeKind::For), target(target), iterator(iterator), body(std::move(body)) {}
+    intern::Symbol target;
     ExpressionPtr iterator;
     std::vector<NodePtr> body;
 };
 
 struct Spawn : Node {
     Spawn() : Node(NodeKind::Spawn) {}
+    explicit Spawn(ExpressionPtr call) : Node(NodeKind::Spawn), call(call) {}
     ExpressionPtr call;
 };
 
 struct Name : Expression {
     Name() : Expression(NodeKind::Name) {}
-    std::string id;
+    explicit Name(intern::Symbol id) : Expression(NodeKind::Name), id(id) {}
+    intern::Symbol id;
 };
 
 struct Number : Expression {
     Number() : Expression(NodeKind::Number) {}
+    explicit Number(double value) : Expression(NodeKind::Number), value(value) {}
     double value = 0.0;
 };
 
 struct String : Expression {
     String() : Expression(NodeKind::String) {}
+    explicit String(std::string value) : Expression(NodeKind::String), value(std::move(value)) {}
     std::string value;
 };
 
 struct Boolean : Expression {
     Boolean() : Expression(NodeKind::Boolean) {}
+    explicit Boolean(bool value) : Expression(NodeKind::Boolean), value(value) {}
     bool value = false;
 };
 
@@ -161,6 +275,8 @@ struct Null : Expression {
 
 struct BinaryOp : Expression {
     BinaryOp() : Expression(NodeKind::BinaryOp) {}
+    BinaryOp(ExpressionPtr left, std::string op, ExpressionPtr right)
+        : Expression(NodeKind::BinaryOp), left(left), op(std::move(op)), right(right) {}
     ExpressionPtr left;
     std::string op;
     ExpressionPtr right;
@@ -168,43 +284,118 @@ struct BinaryOp : Expression {
 
 struct UnaryOp : Expression {
     UnaryOp() : Expression(NodeKind::UnaryOp) {}
+    UnaryOp(std::string op, ExpressionPtr operand)
+        : Expression(NodeKind::UnaryOp), op(std::move(op)), operand(operand) {}
     std::string op;
     ExpressionPtr operand;
 };
 
 struct Call : Expression {
     Call() : Expression(NodeKind::Call) {}
+    Call(ExpressionPtr func, std::vector<ExpressionPtr> args)
+        : Expression(NodeKind::Call), func(func), args(std::move(args)) {}
     ExpressionPtr func;
     std::vector<ExpressionPtr> args;
 };
 
 struct Attribute : Expression {
     Attribute() : Expression(NodeKind::Attribute) {}
+    Attribute(ExpressionPtr value, intern::Symbol attr)
+        : Expression(NodeKind::Attribute), value(value), attr(attr) {}
     ExpressionPtr value;
-    std::string attr;
+    intern::Symbol attr;
 };
 
 struct ListLiteral : Expression {
     ListLiteral() : Expression(NodeKind::ListLiteral) {}
+    explicit ListLiteral(std::vector<ExpressionPtr> elements)
+        : Expression(NodeKind::ListLiteral), elements(std::move(elements)) {}
     std::vector<ExpressionPtr> elements;
 };
 
 struct DictLiteral : Expression {
     DictLiteral() : Expression(NodeKind::DictLiteral) {}
+    explicit DictLiteral(std::vector<std::pair<ExpressionPtr, ExpressionPtr>> pairs)
+        : Expression(NodeKind::DictLiteral), pairs(std::move(pairs)) {}
     std::vector<std::pair<ExpressionPtr, ExpressionPtr>> pairs;
 };
 
-inline ModulePtr make_module() {
-    return std::make_shared<Module>();
+// Statement-level dispatch shared by the code generators (and any pass that
+// walks statement lists). Derived implements one visit_* hook per statement
+// kind, visit_expression_statement for bare expressions, and
+// visit_unsupported for anything else; dispatch resolves at compile time
+// from NodeKind, with no RTTI on the path. Hooks may stay private if the
+// derived class befriends its instantiation.
+template <typename Derived>
+class StatementVisitor {
+   public:
+    void visit(const NodePtr& node) {
+        switch (node->kind) {
+            case NodeKind::Import:
+                derived().visit_import(static_cast<Import*>(node));
+                break;
+            case NodeKind::ImportFrom:
+                derived().visit_import_from(static_cast<ImportFrom*>(node));
+                break;
+            case NodeKind::Let:
+                derived().visit_let(static_cast<Let*>(node));
+                break;
+            case NodeKind::Assign:
+                derived().visit_assign(static_cast<Assign*>(node));
+                break;
+            case NodeKind::FunctionDef:
+                derived().visit_function_def(static_cast<FunctionDef*>(node));
+                break;
+            case NodeKind::Return:
+                derived().visit_return(static_cast<Return*>(node));
+                break;
+            case NodeKind::ExportNames:
+                derived().visit_export_names(static_cast<ExportNames*>(node));
+                break;
+            case NodeKind::ExportDefault:
+                derived().visit_export_default(static_cast<ExportDefault*>(node));
+                break;
+            case NodeKind::If:
+                derived().visit_if(static_cast<If*>(node));
+                break;
+            case NodeKind::While:
+                derived().visit_while(static_cast<While*>(node));
+                break;
+            case NodeKind::For:
+                derived().visit_for(static_cast<For*>(node));
+                break;
+            case NodeKind::Spawn:
+                derived().visit_spawn(static_cast<Spawn*>(node));
+                break;
+            default:
+                if (is_expression_kind(node->kind)) {
+                    derived().visit_expression_statement(static_cast<Expression*>(node));
+                } else {
+                    derived().visit_unsupported(node);
+                }
+        }
+    }
+
+    void visit_body(const std::vector<NodePtr>& body) {
+        for (const auto& stmt : body) {
+            visit(stmt);
+        }
+    }
+
+   private:
+    Derived& derived() { return *static_cast<Derived*>(this); }
+};
+
+inline ModulePtr make_module(Arena& arena) {
+    return arena.create<Module>();
 }
 
+// Constructs the node in place in the arena, forwarding `args` to the node
+// type's constructor. Building a default node and assigning a temporary over
+// it would construct every string and vector member twice.
 template <typename T, typename... Args>
-std::shared_ptr<T> make_node(Args&&... args) {
-    auto node = std::make_shared<T>();
-    if constexpr (sizeof...(Args) > 0) {
-        *node = T{std::forward<Args>(args)...};
-    }
-    return node;
+T* make_node(Arena& arena, Args&&... args) {
+    return arena.create<T>(std::forward<Args>(args)...);
 }
 
 }  // namespace trif::ast
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "ast.hpp"
+
+namespace trif::astio {
+
+// Compact binary encoding of a parsed module (.trifb). Published packages can
+// ship these alongside or instead of sources so deep import graphs load
+// without paying lex/parse cost per build.
+std::string serialize(const ast::ModulePtr& module);
+
+// Reconstructs a module serialized by `serialize` into `arena`. Throws
+// std::runtime_error on malformed or version-mismatched input.
+ast::ModulePtr deserialize(std::string_view data, ast::Arena& arena);
+
+}  // namespace trif::astio
@@ -0,0 +1,53 @@
+#ifndef TRIF_CAPI_H
+#define TRIF_CAPI_H
+
+/* C ABI over trif::compiler::Compiler for in-process embedding (libtrifc).
+ * Callers hand in a source buffer and get generated text and rendered
+ * diagnostics back; no files, pipes, or process spawns are involved. The
+ * Python toolchain binds these entry points via ctypes.
+ *
+ * A session owns one compiler plus its default options (notably the cache
+ * directory), so repeated compiles through the same session share the
+ * output cache. Sessions are not thread-safe; create one per thread.
+ * Every trifc_result must be released with trifc_result_free, and strings
+ * returned from a result stay valid until that call. */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct trifc_session trifc_session;
+typedef struct trifc_result trifc_result;
+
+/* cache_dir may be NULL to disable the output cache. */
+trifc_session* trifc_session_new(const char* cache_dir);
+void trifc_session_free(trifc_session* session);
+
+/* Compiles `length` bytes of Trif source for `target` ("python",
+ * "javascript", or "cpp"). `optimize` of non-zero runs the optimizer
+ * pass pipeline. Returns NULL only when the result cannot be allocated;
+ * otherwise check trifc_result_diagnostic_count to distinguish success
+ * from failure. */
+trifc_result* trifc_compile(trifc_session* session, const char* source, size_t length,
+                            const char* target, int optimize);
+
+/* Generated text, or NULL when the compile produced diagnostics. When
+ * out_length is non-NULL it receives the byte length (the text may not
+ * contain embedded NULs today, but callers should not rely on strlen). */
+const char* trifc_result_output(const trifc_result* result, size_t* out_length);
+
+size_t trifc_result_diagnostic_count(const trifc_result* result);
+
+/* Diagnostic `index` rendered the way the trifc CLI prints it
+ * ("<message> at line L column C"); NULL when index is out of range. */
+const char* trifc_result_diagnostic(const trifc_result* result, size_t index);
+
+void trifc_result_free(trifc_result* result);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TRIF_CAPI_H */
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <iosfwd>
+#include <memory>
 #include <string>
 
 #include "ast.hpp"
@@ -10,16 +12,63 @@ class Generator {
    public:
     virtual ~Generator() = default;
     virtual std::string generate(const ast::ModulePtr& module) = 0;
+    // Streams output to `out` in chunks, never materializing the whole
+    // program as one string.
+    virtual void generate_to(const ast::ModulePtr& module, std::ostream& out) = 0;
 };
 
 class PythonGenerator : public Generator {
    public:
+    // With shared_preamble, the per-module bootstrap (sys.path probing plus
+    // runtime import) is replaced by one import of the `_trif_boot` module —
+    // see python_boot_module() — so a multi-module program probes the
+    // filesystem once instead of once per module.
+    //
+    // With parallel, generate() renders each top-level declaration into its
+    // own buffer on a pool of worker threads and concatenates the buffers in
+    // source order; the output is byte-identical to the sequential walk.
+    // generate_to() always streams sequentially.
+    explicit PythonGenerator(bool shared_preamble = false, bool parallel = false)
+        : shared_preamble_(shared_preamble), parallel_(parallel) {}
     std::string generate(const ast::ModulePtr& module) override;
+    void generate_to(const ast::ModulePtr& module, std::ostream& out) override;
+
+   private:
+    bool shared_preamble_;
+    bool parallel_;
 };
 
 class JavaScriptGenerator : public Generator {
    public:
+    explicit JavaScriptGenerator(bool parallel = false) : parallel_(parallel) {}
     std::string generate(const ast::ModulePtr& module) override;
+    void generate_to(const ast::ModulePtr& module, std::ostream& out) override;
+
+   private:
+    bool parallel_;
 };
 
+// Lowers the full node set to compilable C++ against trif/runtime.hpp.
+class CppGenerator : public Generator {
+   public:
+    explicit CppGenerator(bool parallel = false) : parallel_(parallel) {}
+    std::string generate(const ast::ModulePtr& module) override;
+    void generate_to(const ast::ModulePtr& module, std::ostream& out) override;
+
+   private:
+    bool parallel_;
+};
+
+// Generator for a target name ("python", "javascript"/"js", "cpp"/"c++");
+// null when the name is unknown. `shared_preamble` only affects the Python
+// generator; see PythonGenerator. `parallel` enables per-declaration
+// parallel rendering in generate() for every target.
+std::unique_ptr<Generator> create_generator(const std::string& target,
+                                            bool shared_preamble = false,
+                                            bool parallel = false);
+
+// Source text of the `_trif_boot.py` module that shared-preamble output
+// imports; the build driver writes it once next to the generated files.
+std::string python_boot_module();
+
 }  // namespace trif::codegen
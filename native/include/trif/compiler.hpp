@@ -1,26 +1,97 @@
 #pragma once
 
+#include <cstddef>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "ast.hpp"
+#include "diagnostics.hpp"
 
 namespace trif::compiler {
 
 struct CompileOptions {
     std::string target = "python";
+    // Fail fast: throw on the first lex or parse error instead of recording
+    // diagnostics and recovering.
     bool aggressive_errors = false;
+    bool use_regex_lexer = false;
+    // Lex in newline-aligned chunks on worker threads (lexer::tokenize_parallel);
+    // worthwhile for multi-megabyte machine-generated modules.
+    bool parallel_lexer = false;
+    // Render top-level declarations into per-declaration buffers on worker
+    // threads and concatenate them in source order. Output is byte-identical
+    // to the sequential walk, so it does not enter the cache key.
+    bool parallel_codegen = false;
+    // When set, generated output is cached keyed by source bytes and target;
+    // a hit skips lexing and parsing entirely.
+    std::optional<std::string> cache_dir;
+    // Emit the serialized .trifb module instead of target code.
+    bool emit_ast = false;
+    // Python target only: replace the per-module bootstrap with one import
+    // of a shared _trif_boot module, so a multi-module program probes
+    // sys.path once. The driver writes _trif_boot.py next to the outputs
+    // (codegen::python_boot_module()).
+    bool shared_preamble = false;
+    // Run the optimizer pass pipeline (constant folding, dead-branch
+    // elimination, unused-let removal) between parse and codegen.
+    bool optimize = false;
+    // Record per-phase wall times and item counts on CompileResult::stats.
+    // Lexing is materialized into a token vector so it can be timed apart
+    // from parsing; otherwise the two stream through one cursor.
+    bool time_report = false;
+};
+
+// Wall time and item counts per compiler phase, filled in when
+// CompileOptions::time_report is set; all zero otherwise, and on cache hits
+// (nothing ran). `nodes` counts arena allocations made while parsing, so it
+// doubles as the parse-phase allocation count.
+struct CompileStats {
+    double lex_ms = 0.0;
+    double parse_ms = 0.0;
+    double optimize_ms = 0.0;
+    double codegen_ms = 0.0;
+    std::size_t tokens = 0;
+    std::size_t nodes = 0;
+    std::size_t output_bytes = 0;
+};
+
+// One emitted target from a multi-target compile.
+struct TargetOutput {
+    std::string target;
+    std::string text;
 };
 
 struct CompileResult {
-    ast::ModulePtr module;
+    // Owns every AST node; dropping the result releases the whole tree at once.
+    std::unique_ptr<ast::Arena> arena;
+    ast::ModulePtr module = nullptr;
     std::optional<std::string> output_text;
+    // Every lex and parse error from this compile; output_text is only
+    // produced when the list is empty.
+    diagnostics::DiagnosticList diagnostics;
+    // Filled by the multi-target entry points: one entry per requested
+    // target, in request order; cleared when diagnostics is non-empty.
+    std::vector<TargetOutput> outputs;
+    // Phase timings and counters; see CompileOptions::time_report.
+    CompileStats stats;
 };
 
 class Compiler {
    public:
-    CompileResult compile_source(const std::string& source, const CompileOptions& options = {});
+    CompileResult compile_source(std::string_view source, const CompileOptions& options = {});
+    // Memory-maps `path` and compiles it without copying the bytes.
     CompileResult compile_file(const std::string& path, const CompileOptions& options = {});
+
+    // Multi-target variants: lex and parse once, then run every target's
+    // generator over the shared AST — concurrently, since generation only
+    // reads the tree. `options.target` is ignored in favor of `targets`.
+    CompileResult compile_source(std::string_view source, const std::vector<std::string>& targets,
+                                 const CompileOptions& options = {});
+    CompileResult compile_file(const std::string& path, const std::vector<std::string>& targets,
+                               const CompileOptions& options = {});
 };
 
 }  // namespace trif::compiler
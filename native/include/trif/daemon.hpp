@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+
+#include "compiler.hpp"
+
+namespace trif::daemon {
+
+// Serves compile requests over a unix domain socket until a client sends
+// "shutdown". One warm process handles every request, so per-compile cost is
+// dispatch plus the compile itself rather than process startup.
+//
+// Protocol, one request per exchange:
+//   client:  "compile <target> <byte-count>\n" followed by the source bytes
+//   server:  "ok <byte-count>\n" + output, or "error <byte-count>\n" + message
+//   client:  "shutdown\n" stops the server.
+int serve(const std::string& socket_path, const compiler::CompileOptions& base_options);
+
+}  // namespace trif::daemon
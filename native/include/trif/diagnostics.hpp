@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace trif::diagnostics {
+
+// One recorded compile error. Line and column are 1-based; zero means the
+// position is unknown (e.g. the legacy regex lexer's single failure).
+struct Diagnostic {
+    std::string message;
+    int line = 0;
+    int column = 0;
+};
+
+using DiagnosticList = std::vector<Diagnostic>;
+
+// Renders a diagnostic the way the throwing paths used to word it, so CLI
+// output stays stable across the two error modes.
+inline std::string render(const Diagnostic& diagnostic) {
+    std::string text = diagnostic.message;
+    if (diagnostic.line > 0) {
+        text += " at line " + std::to_string(diagnostic.line);
+        if (diagnostic.column > 0) {
+            text += " column " + std::to_string(diagnostic.column);
+        }
+    }
+    return text;
+}
+
+}  // namespace trif::diagnostics
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include "compiler.hpp"
+
+namespace trif::graph {
+
+// Compiles `entry` and everything it transitively imports. Module names are
+// resolved the way the Python runtime does — dotted paths against the entry
+// root and its trif_pkg/ directory, plus the trif.json manifest layout for
+// installed packages — and independent modules are lexed, parsed, and
+// generated concurrently on `jobs` workers (0 = one per hardware thread).
+// Only the output step is serialized, in dependency order. Returns a process
+// exit code.
+int compile_graph(const std::string& entry, const compiler::CompileOptions& options,
+                  const std::optional<std::string>& output_dir, unsigned jobs);
+
+}  // namespace trif::graph
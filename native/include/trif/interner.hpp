@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace trif::intern {
+
+// Stable handle to one interned identifier spelling. Two symbols compare
+// equal exactly when their spellings do, so name lookups in the optimizer
+// and generators are integer compares instead of string compares. Symbol 0
+// is the empty string, making a default-constructed handle safe to read.
+class Symbol {
+   public:
+    Symbol() = default;
+    friend bool operator==(Symbol, Symbol) = default;
+
+   private:
+    explicit Symbol(std::uint32_t index) : index_(index) {}
+    std::uint32_t index_ = 0;
+
+    friend Symbol intern(std::string_view text);
+    friend const std::string& spelling(Symbol symbol);
+    friend struct std::hash<Symbol>;
+};
+
+// Returns the symbol for `text`, adding it to the table on first sight.
+// The table is process-wide so symbols stay comparable across arenas —
+// watch mode splices statements parsed in different arenas into one module,
+// and batch workers share generators' name lookups.
+Symbol intern(std::string_view text);
+
+// The deduplicated spelling behind `symbol`. The reference stays valid for
+// the life of the process; entries are never removed.
+const std::string& spelling(Symbol symbol);
+
+}  // namespace trif::intern
+
+template <>
+struct std::hash<trif::intern::Symbol> {
+    std::size_t operator()(trif::intern::Symbol symbol) const noexcept {
+        return std::hash<std::uint32_t>{}(symbol.index_);
+    }
+};
@@ -1,16 +1,74 @@
 #pragma once
 
+#include <cstddef>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "diagnostics.hpp"
 #include "token.hpp"
 
 namespace trif::lexer {
 
 using TokenStream = std::vector<Token>;
 
-TokenStream tokenize(const std::string& source);
+// Hand-written DFA scanner; the default lexing path. Token values are views
+// into `source`, which must outlive the returned stream.
+TokenStream tokenize(std::string_view source);
 
-bool is_keyword(const std::string& value);
+// Recovering variant: malformed input is recorded in `diagnostics` and
+// skipped instead of thrown, so one pass surfaces every lex error.
+TokenStream tokenize(std::string_view source, diagnostics::DiagnosticList& diagnostics);
+
+// Chunked parallel variants: the source is split at newlines that fall
+// outside string and block-comment states, each chunk is lexed by its own
+// scanner on a worker thread, and line numbers and byte offsets are fixed up
+// at the seams before the segments are spliced. Token-for-token identical to
+// tokenize(); small inputs fall back to the sequential path. `jobs` of 0
+// means one worker per hardware thread.
+TokenStream tokenize_parallel(std::string_view source, unsigned jobs = 0);
+TokenStream tokenize_parallel(std::string_view source, diagnostics::DiagnosticList& diagnostics,
+                              unsigned jobs = 0);
+
+// Pull-based interface over the DFA scanner: tokens are produced on demand
+// with a two-token window (current + one lookahead), so the parser starts
+// before lexing finishes and the token vector never exists. Can also replay
+// an already-materialized stream so both feed the same parser.
+class TokenCursor {
+   public:
+    explicit TokenCursor(std::string_view source,
+                         diagnostics::DiagnosticList* diagnostics = nullptr);
+    explicit TokenCursor(const TokenStream& tokens);
+    ~TokenCursor();
+
+    TokenCursor(const TokenCursor&) = delete;
+    TokenCursor& operator=(const TokenCursor&) = delete;
+
+    const Token& current() const;
+    // One token past current — the full extent of the lookahead window.
+    const Token& peek() const;
+    // Advances the window. The returned reference stays valid until the next
+    // consume() call.
+    const Token& consume();
+    // Number of tokens consumed so far; used for parser progress checks.
+    std::size_t position() const;
+
+   private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// Legacy regex-table scanner, kept for corpus parity checks until the DFA
+// path has been proven equivalent (see CompileOptions::use_regex_lexer).
+TokenStream tokenize_regex(std::string_view source);
+
+bool is_keyword(std::string_view value);
+
+// Kind for an identifier lexeme: the matching keyword kind, or TokenKind::Name.
+TokenKind keyword_kind(std::string_view value);
+
+// Strips quotes and resolves escape sequences in a raw string lexeme.
+std::string decode_string_literal(std::string_view raw);
 
 }  // namespace trif::lexer
@@ -0,0 +1,14 @@
+#pragma once
+
+namespace trif::lsp {
+
+// Language Server Protocol server over stdio (Content-Length framed
+// JSON-RPC), intended to back the VS Code extension. Each open document
+// keeps its parsed ast::Module resident and is re-parsed on change with the
+// recovering lexer and parser, so diagnostics and document symbols are
+// served from the native AST instead of re-running Python analysis per
+// edit. Supports full-document sync, publishDiagnostics, and
+// textDocument/documentSymbol. Runs until the client sends "exit".
+int serve();
+
+}  // namespace trif::lsp
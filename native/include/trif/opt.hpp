@@ -0,0 +1,13 @@
+#pragma once
+
+#include "ast.hpp"
+
+namespace trif::opt {
+
+// Runs the -O pass pipeline over a parsed module in place: constant folding
+// of BinaryOp/UnaryOp over literal operands, dead-branch elimination for If
+// nodes with constant tests, and removal of unused side-effect-free lets.
+// New literal nodes are allocated from `arena`.
+void optimize(ast::ModulePtr module, ast::Arena& arena);
+
+}  // namespace trif::opt
@@ -1,15 +1,36 @@
 #pragma once
 
 #include <memory>
+#include <string_view>
 #include <vector>
 
 #include "ast.hpp"
+#include "diagnostics.hpp"
 #include "lexer.hpp"
 
 namespace trif::parser {
 
 using ast::ModulePtr;
 
-ModulePtr parse(const lexer::TokenStream& tokens);
+// Every variant takes the source buffer the tokens were lexed from: tokens
+// carry byte offsets only, and the parser turns an offending token's offset
+// into line/column through a lazy source::SourceManager when it reports an
+// error — error-free parses never touch the index.
+
+// Parses into `arena`, which must outlive the returned module. Throws on the
+// first syntax error.
+ModulePtr parse(std::string_view source, const lexer::TokenStream& tokens, ast::Arena& arena);
+
+// Recovering variant: records each syntax error in `diagnostics`, resumes at
+// the next statement boundary (NEWLINE/RBRACE), and returns whatever module
+// could be built. The module is only meaningful when `diagnostics` stays empty.
+ModulePtr parse(std::string_view source, const lexer::TokenStream& tokens, ast::Arena& arena,
+                diagnostics::DiagnosticList& diagnostics);
+
+// Pull-based variants: tokens are drawn from `cursor` as parsing proceeds, so
+// source, token window, and AST are the only live state — no token vector.
+ModulePtr parse(std::string_view source, lexer::TokenCursor& cursor, ast::Arena& arena);
+ModulePtr parse(std::string_view source, lexer::TokenCursor& cursor, ast::Arena& arena,
+                diagnostics::DiagnosticList& diagnostics);
 
 }  // namespace trif::parser
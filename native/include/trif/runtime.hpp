@@ -0,0 +1,537 @@
+#pragma once
+
+// Native runtime for the C++ target. Generated modules include this header
+// and drive a Runtime instance: Trif values are dynamically typed `Value`s,
+// functions are first-class closures, and imports resolve against the
+// built-in module registry (a native subset of trif_lang/std).
+//
+// Generated functions are closures with reference captures, so a function
+// value must not outlive the scope that declared it. Spawned tasks capture
+// their operands by value, since a task can outlive the frame that spawned
+// it.
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace trif::runtime {
+
+class Value;
+
+using ValueList = std::vector<Value>;
+using ValueDict = std::map<std::string, Value>;
+using NativeFunction = std::function<Value(const ValueList&)>;
+
+class Value {
+   public:
+    enum class Kind { Null, Boolean, Number, String, List, Dict, Function };
+
+    Value() : kind_(Kind::Null) {}
+    explicit Value(bool value) : kind_(Kind::Boolean), boolean_(value) {}
+    explicit Value(double value) : kind_(Kind::Number), number_(value) {}
+    explicit Value(const char* value)
+        : kind_(Kind::String), string_(std::make_shared<std::string>(value)) {}
+    explicit Value(std::string value)
+        : kind_(Kind::String), string_(std::make_shared<std::string>(std::move(value))) {}
+
+    static Value list(ValueList elements) {
+        Value value;
+        value.kind_ = Kind::List;
+        value.list_ = std::make_shared<ValueList>(std::move(elements));
+        return value;
+    }
+
+    static Value dict(std::vector<std::pair<Value, Value>> pairs) {
+        Value value;
+        value.kind_ = Kind::Dict;
+        value.dict_ = std::make_shared<ValueDict>();
+        for (auto& [key, item] : pairs) {
+            (*value.dict_)[key.str()] = item;
+        }
+        return value;
+    }
+
+    static Value dict(ValueDict entries) {
+        Value value;
+        value.kind_ = Kind::Dict;
+        value.dict_ = std::make_shared<ValueDict>(std::move(entries));
+        return value;
+    }
+
+    static Value function(NativeFunction fn) {
+        Value value;
+        value.kind_ = Kind::Function;
+        value.function_ = std::make_shared<NativeFunction>(std::move(fn));
+        return value;
+    }
+
+    Kind kind() const { return kind_; }
+    bool is_null() const { return kind_ == Kind::Null; }
+
+    bool truthy() const {
+        switch (kind_) {
+            case Kind::Null: return false;
+            case Kind::Boolean: return boolean_;
+            case Kind::Number: return number_ != 0.0;
+            case Kind::String: return !string_->empty();
+            case Kind::List: return !list_->empty();
+            case Kind::Dict: return !dict_->empty();
+            case Kind::Function: return true;
+        }
+        return false;
+    }
+
+    double number() const {
+        if (kind_ != Kind::Number) {
+            throw std::runtime_error("Expected a number, got " + type_name());
+        }
+        return number_;
+    }
+
+    std::string str() const {
+        switch (kind_) {
+            case Kind::Null: return "null";
+            case Kind::Boolean: return boolean_ ? "true" : "false";
+            case Kind::Number: {
+                std::ostringstream oss;
+                oss << number_;
+                return oss.str();
+            }
+            case Kind::String: return *string_;
+            case Kind::List: {
+                std::string result = "[";
+                for (std::size_t i = 0; i < list_->size(); ++i) {
+                    if (i != 0) {
+                        result += ", ";
+                    }
+                    result += (*list_)[i].str();
+                }
+                return result + "]";
+            }
+            case Kind::Dict: {
+                std::string result = "{";
+                bool first = true;
+                for (const auto& [key, item] : *dict_) {
+                    if (!first) {
+                        result += ", ";
+                    }
+                    first = false;
+                    result += key + ": " + item.str();
+                }
+                return result + "}";
+            }
+            case Kind::Function: return "<function>";
+        }
+        return "";
+    }
+
+    std::string type_name() const {
+        switch (kind_) {
+            case Kind::Null: return "null";
+            case Kind::Boolean: return "boolean";
+            case Kind::Number: return "number";
+            case Kind::String: return "string";
+            case Kind::List: return "list";
+            case Kind::Dict: return "dict";
+            case Kind::Function: return "function";
+        }
+        return "unknown";
+    }
+
+    const ValueList& elements() const {
+        if (kind_ != Kind::List) {
+            throw std::runtime_error("Expected a list, got " + type_name());
+        }
+        return *list_;
+    }
+
+    ValueDict& entries() const {
+        if (kind_ != Kind::Dict) {
+            throw std::runtime_error("Expected a dict, got " + type_name());
+        }
+        return *dict_;
+    }
+
+    const NativeFunction& callable() const {
+        if (kind_ != Kind::Function) {
+            throw std::runtime_error("Value is not callable: " + type_name());
+        }
+        return *function_;
+    }
+
+    Value operator+(const Value& other) const {
+        if (kind_ == Kind::Number && other.kind_ == Kind::Number) {
+            return Value(number_ + other.number_);
+        }
+        if (kind_ == Kind::String && other.kind_ == Kind::String) {
+            return Value(*string_ + *other.string_);
+        }
+        if (kind_ == Kind::List && other.kind_ == Kind::List) {
+            ValueList combined = *list_;
+            combined.insert(combined.end(), other.list_->begin(), other.list_->end());
+            return Value::list(std::move(combined));
+        }
+        if (kind_ == Kind::String || other.kind_ == Kind::String) {
+            return Value(str() + other.str());
+        }
+        throw std::runtime_error("Unsupported operands for +: " + type_name() + " and " + other.type_name());
+    }
+
+    Value operator-(const Value& other) const { return Value(number() - other.number()); }
+    Value operator*(const Value& other) const { return Value(number() * other.number()); }
+    Value operator/(const Value& other) const { return Value(number() / other.number()); }
+    Value operator%(const Value& other) const { return Value(std::fmod(number(), other.number())); }
+    Value operator-() const { return Value(-number()); }
+
+    bool equals(const Value& other) const {
+        if (kind_ != other.kind_) {
+            return false;
+        }
+        switch (kind_) {
+            case Kind::Null: return true;
+            case Kind::Boolean: return boolean_ == other.boolean_;
+            case Kind::Number: return number_ == other.number_;
+            case Kind::String: return *string_ == *other.string_;
+            case Kind::List: {
+                if (list_->size() != other.list_->size()) {
+                    return false;
+                }
+                for (std::size_t i = 0; i < list_->size(); ++i) {
+                    if (!(*list_)[i].equals((*other.list_)[i])) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            case Kind::Dict: return dict_ == other.dict_;
+            case Kind::Function: return function_ == other.function_;
+        }
+        return false;
+    }
+
+    Value operator==(const Value& other) const { return Value(equals(other)); }
+    Value operator!=(const Value& other) const { return Value(!equals(other)); }
+
+    Value operator<(const Value& other) const { return Value(compare(other) < 0); }
+    Value operator<=(const Value& other) const { return Value(compare(other) <= 0); }
+    Value operator>(const Value& other) const { return Value(compare(other) > 0); }
+    Value operator>=(const Value& other) const { return Value(compare(other) >= 0); }
+
+   private:
+    int compare(const Value& other) const {
+        if (kind_ == Kind::Number && other.kind_ == Kind::Number) {
+            if (number_ < other.number_) return -1;
+            return number_ > other.number_ ? 1 : 0;
+        }
+        if (kind_ == Kind::String && other.kind_ == Kind::String) {
+            return string_->compare(*other.string_);
+        }
+        throw std::runtime_error("Unsupported comparison between " + type_name() + " and " +
+                                 other.type_name());
+    }
+
+    Kind kind_;
+    bool boolean_ = false;
+    double number_ = 0.0;
+    std::shared_ptr<std::string> string_;
+    std::shared_ptr<ValueList> list_;
+    std::shared_ptr<ValueDict> dict_;
+    std::shared_ptr<NativeFunction> function_;
+};
+
+// Work-stealing scheduler backing the `spawn` statement. Each worker owns a
+// deque: a worker pushes and pops its own tasks LIFO at the back, and an idle
+// worker steals FIFO from the front of another's, so spawning in a loop
+// costs an enqueue rather than an OS thread. Spawns from worker threads land
+// on the spawning worker's own deque; external spawns are distributed
+// round-robin. Task closures go through std::function like every other
+// callable in this runtime — with the reference captures the generator
+// emits, they fit its small-buffer storage.
+class TaskScheduler {
+   public:
+    using Task = std::function<void()>;
+
+    explicit TaskScheduler(unsigned worker_count = 0) {
+        unsigned count =
+            worker_count ? worker_count : std::max(1u, std::thread::hardware_concurrency());
+        queues_.reserve(count);
+        for (unsigned i = 0; i < count; ++i) {
+            queues_.push_back(std::make_unique<Queue>());
+        }
+        workers_.reserve(count);
+        for (unsigned i = 0; i < count; ++i) {
+            workers_.emplace_back([this, i] { run_worker(i); });
+        }
+    }
+
+    // Drains outstanding tasks before stopping, preserving the old
+    // join-every-thread semantics of Runtime teardown.
+    ~TaskScheduler() {
+        {
+            std::unique_lock lock(sleep_mutex_);
+            idle_.wait(lock, [this] { return pending_.load() == 0; });
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+        // A failure nothing collected via wait_idle must not vanish in
+        // teardown (and a destructor cannot rethrow), so report it here.
+        if (failure_) {
+            try {
+                std::rethrow_exception(failure_);
+            } catch (const std::exception& exc) {
+                std::cerr << "trif: spawned task failed: " << exc.what() << std::endl;
+            } catch (...) {
+                std::cerr << "trif: spawned task failed" << std::endl;
+            }
+        }
+    }
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    void submit(Task task) {
+        pending_.fetch_add(1);
+        Queue& queue = *queues_[home_queue()];
+        {
+            std::scoped_lock lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        {
+            std::scoped_lock lock(sleep_mutex_);
+            ++queued_;
+        }
+        wake_.notify_one();
+    }
+
+    // Blocks until every submitted task (including ones spawned by running
+    // tasks) has finished, then rethrows the first exception any of them
+    // raised.
+    void wait_idle() {
+        std::unique_lock lock(sleep_mutex_);
+        idle_.wait(lock, [this] { return pending_.load() == 0; });
+        if (failure_) {
+            auto failure = std::exchange(failure_, nullptr);
+            lock.unlock();
+            std::rethrow_exception(failure);
+        }
+    }
+
+   private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    static constexpr std::size_t kNoWorker = static_cast<std::size_t>(-1);
+
+    std::size_t home_queue() {
+        if (tls_owner == this && tls_worker != kNoWorker) {
+            return tls_worker;
+        }
+        return next_queue_.fetch_add(1) % queues_.size();
+    }
+
+    bool take_task(std::size_t self, Task& task) {
+        {
+            Queue& own = *queues_[self];
+            std::scoped_lock lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        for (std::size_t i = 1; i < queues_.size(); ++i) {
+            Queue& victim = *queues_[(self + i) % queues_.size()];
+            std::scoped_lock lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run_worker(std::size_t self) {
+        tls_owner = this;
+        tls_worker = self;
+        for (;;) {
+            Task task;
+            if (take_task(self, task)) {
+                {
+                    std::scoped_lock lock(sleep_mutex_);
+                    --queued_;
+                }
+                // A throwing task must not escape the worker (that would
+                // std::terminate the process); record the first failure for
+                // wait_idle to rethrow.
+                try {
+                    task();
+                } catch (...) {
+                    std::scoped_lock lock(sleep_mutex_);
+                    if (!failure_) {
+                        failure_ = std::current_exception();
+                    }
+                }
+                if (pending_.fetch_sub(1) == 1) {
+                    std::scoped_lock lock(sleep_mutex_);
+                    idle_.notify_all();
+                }
+                continue;
+            }
+            std::unique_lock lock(sleep_mutex_);
+            wake_.wait(lock, [this] { return stopping_ || queued_ > 0; });
+            if (stopping_) {
+                return;
+            }
+        }
+    }
+
+    // Which scheduler's worker this thread is, if any; lets nested spawns
+    // stay on the spawning worker's deque.
+    static thread_local TaskScheduler* tls_owner;
+    static thread_local std::size_t tls_worker;
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<std::size_t> next_queue_{0};
+    // Submitted and not yet finished; wait_idle blocks on this reaching zero.
+    std::atomic<std::size_t> pending_{0};
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    // Tasks sitting in deques, guarded by sleep_mutex_ so a worker that saw
+    // empty queues cannot miss the wakeup for a concurrent submit.
+    std::size_t queued_ = 0;
+    bool stopping_ = false;
+    // First exception thrown by a task, guarded by sleep_mutex_; handed to
+    // the next wait_idle caller, or reported at teardown if none comes.
+    std::exception_ptr failure_;
+};
+
+inline thread_local TaskScheduler* TaskScheduler::tls_owner = nullptr;
+inline thread_local std::size_t TaskScheduler::tls_worker = TaskScheduler::kNoWorker;
+
+class Runtime {
+   public:
+    Runtime() = default;
+
+    Value create_module() { return Value::dict(ValueDict{}); }
+
+    Value import_module(const std::string& name) {
+        auto it = modules_.find(name);
+        if (it != modules_.end()) {
+            return it->second;
+        }
+        Value module = builtin_module(name);
+        modules_.emplace(name, module);
+        return module;
+    }
+
+    Value call(const Value& fn, ValueList args) { return fn.callable()(args); }
+
+    static Value arg(const ValueList& args, std::size_t index) {
+        return index < args.size() ? args[index] : Value();
+    }
+
+    Value get_attr(const Value& value, const std::string& name) {
+        auto& entries = value.entries();
+        auto it = entries.find(name);
+        if (it == entries.end()) {
+            throw std::runtime_error("Unknown attribute: " + name);
+        }
+        return it->second;
+    }
+
+    void set_attr(Value& value, const std::string& name, const Value& item) {
+        value.entries()[name] = item;
+    }
+
+    Value extract_default(const Value& module) {
+        auto& entries = module.entries();
+        auto it = entries.find("__default__");
+        return it == entries.end() ? Value() : it->second;
+    }
+
+    Value extract_export(const Value& module, const std::string& name) {
+        return get_attr(module, name);
+    }
+
+    void set_export(Value& exports, const std::string& name, const Value& value) {
+        exports.entries()[name] = value;
+    }
+
+    void register_module(const Value& exports, const Value& default_export) {
+        (void)exports;
+        (void)default_export;
+    }
+
+    void spawn(std::function<Value()> task) {
+        scheduler_.submit([task = std::move(task)] { task(); });
+    }
+
+    const ValueList& iterate(const Value& value) { return value.elements(); }
+
+   private:
+    Value builtin_module(const std::string& name) {
+        if (name == "std.io") {
+            ValueDict entries;
+            entries["println"] = Value::function([](const ValueList& args) {
+                std::cout << arg(args, 0).str() << std::endl;
+                return Value();
+            });
+            entries["print"] = Value::function([](const ValueList& args) {
+                std::cout << arg(args, 0).str();
+                return Value();
+            });
+            entries["prompt"] = Value::function([](const ValueList& args) {
+                std::cout << arg(args, 0).str();
+                std::string input;
+                std::getline(std::cin, input);
+                return Value(input);
+            });
+            return Value::dict(std::move(entries));
+        }
+        if (name == "std.math") {
+            ValueDict entries;
+            entries["abs"] = Value::function(
+                [](const ValueList& args) { return Value(std::fabs(arg(args, 0).number())); });
+            entries["floor"] = Value::function(
+                [](const ValueList& args) { return Value(std::floor(arg(args, 0).number())); });
+            entries["ceil"] = Value::function(
+                [](const ValueList& args) { return Value(std::ceil(arg(args, 0).number())); });
+            entries["sqrt"] = Value::function(
+                [](const ValueList& args) { return Value(std::sqrt(arg(args, 0).number())); });
+            entries["pow"] = Value::function([](const ValueList& args) {
+                return Value(std::pow(arg(args, 0).number(), arg(args, 1).number()));
+            });
+            entries["pi"] = Value(3.14159265358979323846);
+            return Value::dict(std::move(entries));
+        }
+        throw std::runtime_error("Unknown module in native runtime: " + name);
+    }
+
+    std::map<std::string, Value> modules_;
+    // Destroyed with the runtime, which drains every spawned task first.
+    TaskScheduler scheduler_;
+};
+
+}  // namespace trif::runtime
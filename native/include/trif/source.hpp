@@ -0,0 +1,51 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace trif::source {
+
+// 1-based line/column pair, matching diagnostics::Diagnostic.
+struct LineColumn {
+    int line = 0;
+    int column = 0;
+};
+
+// Converts byte offsets into line/column positions over one source buffer.
+// Tokens carry only their byte offset (see lexer::Token); the newline index
+// that maps offsets back to positions is built lazily on the first lookup,
+// so the diagnostic-free compile never pays for it. The buffer must outlive
+// the manager. Lookups are const but not thread-safe while the index is
+// still unbuilt.
+class SourceManager {
+   public:
+    explicit SourceManager(std::string_view source) : source_(source) {}
+
+    LineColumn position(std::size_t offset) const {
+        if (line_starts_.empty()) {
+            build_index();
+        }
+        auto it = std::upper_bound(line_starts_.begin(), line_starts_.end(), offset);
+        std::size_t line = static_cast<std::size_t>(it - line_starts_.begin());
+        return {static_cast<int>(line),
+                static_cast<int>(offset - line_starts_[line - 1]) + 1};
+    }
+
+   private:
+    void build_index() const {
+        line_starts_.push_back(0);
+        for (std::size_t i = 0; i < source_.size(); ++i) {
+            if (source_[i] == '\n') {
+                line_starts_.push_back(i + 1);
+            }
+        }
+    }
+
+    std::string_view source_;
+    // Byte offset of each line start; lazily filled by position().
+    mutable std::vector<std::size_t> line_starts_;
+};
+
+}  // namespace trif::source
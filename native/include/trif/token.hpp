@@ -1,14 +1,58 @@
 #pragma once
 
-#include <string>
+#include <cstddef>
+#include <string_view>
 
 namespace trif::lexer {
 
+enum class TokenKind {
+    Eof,
+    Newline,
+    Name,
+    Number,
+    String,
+    Op,
+    Lparen,
+    Rparen,
+    Lbrace,
+    Rbrace,
+    Lbracket,
+    Rbracket,
+    Comma,
+    Colon,
+    Dot,
+    Semicolon,
+    // Keywords
+    Let,
+    Fn,
+    Function,
+    Return,
+    If,
+    Else,
+    While,
+    For,
+    In,
+    True,
+    False,
+    Null,
+    Import,
+    As,
+    From,
+    Const,
+    Export,
+    Default,
+    Spawn,
+};
+
+// Uppercase spelling of a kind ("NEWLINE", "OP", ...), used in diagnostics.
+const char* token_kind_name(TokenKind kind);
+
+// Position is the byte offset alone; line/column pairs are only needed on
+// error paths and are recovered from the offset by source::SourceManager.
 struct Token {
-    std::string type;
-    std::string value;
-    int line;
-    int column;
+    TokenKind kind;
+    std::string_view value;   // view into the retained source buffer
+    std::size_t offset;       // byte offset of the lexeme in the source
 };
 
 }  // namespace trif::lexer
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+
+#include "compiler.hpp"
+
+namespace trif::watch {
+
+// Blocks watching `input` and recompiles to `output_path` on every change.
+// The parsed module stays resident between saves: the edited byte range is
+// mapped onto the recorded per-statement source spans and only the affected
+// top-level declarations are re-lexed and re-parsed, falling back to a full
+// parse when the change cannot be mapped. Runs until the process is killed.
+int serve(const std::string& input, const std::string& output_path,
+          const compiler::CompileOptions& options);
+
+}  // namespace trif::watch
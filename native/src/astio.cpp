@@ -0,0 +1,518 @@
+#include "trif/astio.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace trif::astio {
+
+using namespace trif::ast;
+
+namespace {
+
+constexpr char kMagic[4] = {'T', 'R', 'F', 'B'};
+constexpr std::uint32_t kVersion = 1;
+
+class Writer {
+   public:
+    std::string take() { return std::move(buffer_); }
+
+    void byte(std::uint8_t value) { buffer_.push_back(static_cast<char>(value)); }
+
+    void varint(std::uint64_t value) {
+        while (value >= 0x80) {
+            byte(static_cast<std::uint8_t>(value) | 0x80);
+            value >>= 7;
+        }
+        byte(static_cast<std::uint8_t>(value));
+    }
+
+    void number(double value) {
+        char bytes[sizeof(double)];
+        std::memcpy(bytes, &value, sizeof(double));
+        buffer_.append(bytes, sizeof(double));
+    }
+
+    void string(const std::string& value) {
+        varint(value.size());
+        buffer_.append(value);
+    }
+
+    void optional_string(const std::optional<std::string>& value) {
+        byte(value ? 1 : 0);
+        if (value) {
+            string(*value);
+        }
+    }
+
+    void name_pairs(const std::vector<std::pair<std::string, std::string>>& names) {
+        varint(names.size());
+        for (const auto& [first, second] : names) {
+            string(first);
+            string(second);
+        }
+    }
+
+   private:
+    std::string buffer_;
+};
+
+class Reader {
+   public:
+    explicit Reader(std::string_view data) : data_(data) {}
+
+    std::uint8_t byte() {
+        if (offset_ >= data_.size()) {
+            throw std::runtime_error("Corrupt .trifb module: unexpected end of data");
+        }
+        return static_cast<std::uint8_t>(data_[offset_++]);
+    }
+
+    std::uint64_t varint() {
+        std::uint64_t value = 0;
+        int shift = 0;
+        while (true) {
+            std::uint8_t part = byte();
+            value |= static_cast<std::uint64_t>(part & 0x7f) << shift;
+            if (!(part & 0x80)) {
+                return value;
+            }
+            shift += 7;
+            if (shift > 63) {
+                throw std::runtime_error("Corrupt .trifb module: varint overflow");
+            }
+        }
+    }
+
+    double number() {
+        if (offset_ + sizeof(double) > data_.size()) {
+            throw std::runtime_error("Corrupt .trifb module: unexpected end of data");
+        }
+        double value;
+        std::memcpy(&value, data_.data() + offset_, sizeof(double));
+        offset_ += sizeof(double);
+        return value;
+    }
+
+    std::string string() {
+        std::uint64_t size = varint();
+        if (offset_ + size > data_.size()) {
+            throw std::runtime_error("Corrupt .trifb module: string extends past end of data");
+        }
+        std::string value(data_.substr(offset_, size));
+        offset_ += size;
+        return value;
+    }
+
+    std::optional<std::string> optional_string() {
+        if (byte() == 0) {
+            return std::nullopt;
+        }
+        return string();
+    }
+
+    std::vector<std::pair<std::string, std::string>> name_pairs() {
+        std::vector<std::pair<std::string, std::string>> names;
+        std::uint64_t count = varint();
+        names.reserve(count);
+        for (std::uint64_t i = 0; i < count; ++i) {
+            std::string first = string();
+            std::string second = string();
+            names.emplace_back(std::move(first), std::move(second));
+        }
+        return names;
+    }
+
+   private:
+    std::string_view data_;
+    std::size_t offset_ = 0;
+};
+
+void write_node(Writer& out, NodePtr node);
+
+void write_body(Writer& out, const std::vector<NodePtr>& body) {
+    out.varint(body.size());
+    for (const auto& stmt : body) {
+        write_node(out, stmt);
+    }
+}
+
+void write_node(Writer& out, NodePtr node) {
+    out.byte(static_cast<std::uint8_t>(node->kind));
+    switch (node->kind) {
+        case NodeKind::Module:
+            write_body(out, static_cast<Module*>(node)->body);
+            break;
+        case NodeKind::ImportFrom: {
+            auto* import = static_cast<ImportFrom*>(node);
+            out.string(import->module);
+            out.name_pairs(import->names);
+            out.optional_string(import->default_name);
+            out.optional_string(import->namespace_name);
+            break;
+        }
+        case NodeKind::Import: {
+            auto* import = static_cast<Import*>(node);
+            out.string(import->module);
+            out.optional_string(import->alias);
+            break;
+        }
+        case NodeKind::Let: {
+            auto* let = static_cast<Let*>(node);
+            out.string(intern::spelling(let->name));
+            write_node(out, let->value);
+            out.byte(static_cast<std::uint8_t>((let->mutable_flag ? 1 : 0) | (let->exported ? 2 : 0) |
+                                               (let->is_default ? 4 : 0)));
+            break;
+        }
+        case NodeKind::Assign: {
+            auto* assign = static_cast<Assign*>(node);
+            write_node(out, assign->target);
+            write_node(out, assign->value);
+            break;
+        }
+        case NodeKind::FunctionDef: {
+            auto* fn = static_cast<FunctionDef*>(node);
+            out.string(intern::spelling(fn->name));
+            out.varint(fn->params.size());
+            for (const auto& param : fn->params) {
+                out.string(intern::spelling(param));
+            }
+            write_body(out, fn->body);
+            out.byte(static_cast<std::uint8_t>((fn->exported ? 1 : 0) | (fn->is_default ? 2 : 0)));
+            break;
+        }
+        case NodeKind::ExportNames: {
+            auto* names = static_cast<ExportNames*>(node);
+            out.name_pairs(names->names);
+            out.optional_string(names->source);
+            break;
+        }
+        case NodeKind::ExportDefault:
+            write_node(out, static_cast<ExportDefault*>(node)->value);
+            break;
+        case NodeKind::Return: {
+            auto* ret = static_cast<Return*>(node);
+            out.byte(ret->value ? 1 : 0);
+            if (ret->value) {
+                write_node(out, *ret->value);
+            }
+            break;
+        }
+        case NodeKind::If: {
+            auto* branch = static_cast<If*>(node);
+            write_node(out, branch->test);
+            write_body(out, branch->body);
+            write_body(out, branch->orelse);
+            break;
+        }
+        case NodeKind::While: {
+            auto* loop = static_cast<While*>(node);
+            write_node(out, loop->test);
+            write_body(out, loop->body);
+            break;
+        }
+        case NodeKind::For: {
+            auto* loop = static_cast<For*>(node);
+            out.string(intern::spelling(loop->target));
+            write_node(out, loop->iterator);
+            write_body(out, loop->body);
+            break;
+        }
+        case NodeKind::Spawn:
+            write_node(out, static_cast<Spawn*>(node)->call);
+            break;
+        case NodeKind::Name:
+            out.string(intern::spelling(static_cast<Name*>(node)->id));
+            break;
+        case NodeKind::Number:
+            out.number(static_cast<Number*>(node)->value);
+            break;
+        case NodeKind::String:
+            out.string(static_cast<String*>(node)->value);
+            break;
+        case NodeKind::Boolean:
+            out.byte(static_cast<Boolean*>(node)->value ? 1 : 0);
+            break;
+        case NodeKind::Null:
+            break;
+        case NodeKind::BinaryOp: {
+            auto* op = static_cast<BinaryOp*>(node);
+            write_node(out, op->left);
+            out.string(op->op);
+            write_node(out, op->right);
+            break;
+        }
+        case NodeKind::UnaryOp: {
+            auto* op = static_cast<UnaryOp*>(node);
+            out.string(op->op);
+            write_node(out, op->operand);
+            break;
+        }
+        case NodeKind::Call: {
+            auto* call = static_cast<Call*>(node);
+            write_node(out, call->func);
+            out.varint(call->args.size());
+            for (const auto& arg : call->args) {
+                write_node(out, arg);
+            }
+            break;
+        }
+        case NodeKind::Attribute: {
+            auto* attr = static_cast<Attribute*>(node);
+            write_node(out, attr->value);
+            out.string(intern::spelling(attr->attr));
+            break;
+        }
+        case NodeKind::ListLiteral: {
+            auto* list = static_cast<ListLiteral*>(node);
+            out.varint(list->elements.size());
+            for (const auto& element : list->elements) {
+                write_node(out, element);
+            }
+            break;
+        }
+        case NodeKind::DictLiteral: {
+            auto* dict = static_cast<DictLiteral*>(node);
+            out.varint(dict->pairs.size());
+            for (const auto& [key, value] : dict->pairs) {
+                write_node(out, key);
+                write_node(out, value);
+            }
+            break;
+        }
+    }
+}
+
+NodePtr read_node(Reader& in, Arena& arena);
+
+ExpressionPtr read_expression(Reader& in, Arena& arena) {
+    NodePtr node = read_node(in, arena);
+    switch (node->kind) {
+        case NodeKind::Name:
+        case NodeKind::Number:
+        case NodeKind::String:
+        case NodeKind::Boolean:
+        case NodeKind::Null:
+        case NodeKind::BinaryOp:
+        case NodeKind::UnaryOp:
+        case NodeKind::Call:
+        case NodeKind::Attribute:
+        case NodeKind::ListLiteral:
+        case NodeKind::DictLiteral:
+            return static_cast<Expression*>(node);
+        default:
+            throw std::runtime_error("Corrupt .trifb module: expected an expression node");
+    }
+}
+
+std::vector<NodePtr> read_body(Reader& in, Arena& arena) {
+    std::vector<NodePtr> body;
+    std::uint64_t count = in.varint();
+    body.reserve(count);
+    for (std::uint64_t i = 0; i < count; ++i) {
+        body.push_back(read_node(in, arena));
+    }
+    return body;
+}
+
+NodePtr read_node(Reader& in, Arena& arena) {
+    auto kind = static_cast<NodeKind>(in.byte());
+    switch (kind) {
+        case NodeKind::Module: {
+            auto* module = arena.create<Module>();
+            module->body = read_body(in, arena);
+            return module;
+        }
+        case NodeKind::ImportFrom: {
+            auto* import = arena.create<ImportFrom>();
+            import->module = in.string();
+            import->names = in.name_pairs();
+            import->default_name = in.optional_string();
+            import->namespace_name = in.optional_string();
+            return import;
+        }
+        case NodeKind::Import: {
+            auto* import = arena.create<Import>();
+            import->module = in.string();
+            import->alias = in.optional_string();
+            return import;
+        }
+        case NodeKind::Let: {
+            auto* let = arena.create<Let>();
+            let->name = intern::intern(in.string());
+            let->value = read_expression(in, arena);
+            std::uint8_t flags = in.byte();
+            let->mutable_flag = flags & 1;
+            let->exported = flags & 2;
+            let->is_default = flags & 4;
+            return let;
+        }
+        case NodeKind::Assign: {
+            auto* assign = arena.create<Assign>();
+            assign->target = read_expression(in, arena);
+            assign->value = read_expression(in, arena);
+            return assign;
+        }
+        case NodeKind::FunctionDef: {
+            auto* fn = arena.create<FunctionDef>();
+            fn->name = intern::intern(in.string());
+            std::uint64_t count = in.varint();
+            fn->params.reserve(count);
+            for (std::uint64_t i = 0; i < count; ++i) {
+                fn->params.push_back(intern::intern(in.string()));
+            }
+            fn->body = read_body(in, arena);
+            std::uint8_t flags = in.byte();
+            fn->exported = flags & 1;
+            fn->is_default = flags & 2;
+            return fn;
+        }
+        case NodeKind::ExportNames: {
+            auto* names = arena.create<ExportNames>();
+            names->names = in.name_pairs();
+            names->source = in.optional_string();
+            return names;
+        }
+        case NodeKind::ExportDefault: {
+            auto* node = arena.create<ExportDefault>();
+            node->value = read_expression(in, arena);
+            return node;
+        }
+        case NodeKind::Return: {
+            auto* ret = arena.create<Return>();
+            if (in.byte()) {
+                ret->value = read_expression(in, arena);
+            }
+            return ret;
+        }
+        case NodeKind::If: {
+            auto* branch = arena.create<If>();
+            branch->test = read_expression(in, arena);
+            branch->body = read_body(in, arena);
+            branch->orelse = read_body(in, arena);
+            return branch;
+        }
+        case NodeKind::While: {
+            auto* loop = arena.create<While>();
+            loop->test = read_expression(in, arena);
+            loop->body = read_body(in, arena);
+            return loop;
+        }
+        case NodeKind::For: {
+            auto* loop = arena.create<For>();
+            loop->target = intern::intern(in.string());
+            loop->iterator = read_expression(in, arena);
+            loop->body = read_body(in, arena);
+            return loop;
+        }
+        case NodeKind::Spawn: {
+            auto* node = arena.create<Spawn>();
+            node->call = read_expression(in, arena);
+            return node;
+        }
+        case NodeKind::Name: {
+            auto* name = arena.create<Name>();
+            name->id = intern::intern(in.string());
+            return name;
+        }
+        case NodeKind::Number: {
+            auto* number = arena.create<Number>();
+            number->value = in.number();
+            return number;
+        }
+        case NodeKind::String: {
+            auto* text = arena.create<String>();
+            text->value = in.string();
+            return text;
+        }
+        case NodeKind::Boolean: {
+            auto* boolean = arena.create<Boolean>();
+            boolean->value = in.byte() != 0;
+            return boolean;
+        }
+        case NodeKind::Null:
+            return arena.create<Null>();
+        case NodeKind::BinaryOp: {
+            auto* op = arena.create<BinaryOp>();
+            op->left = read_expression(in, arena);
+            op->op = in.string();
+            op->right = read_expression(in, arena);
+            return op;
+        }
+        case NodeKind::UnaryOp: {
+            auto* op = arena.create<UnaryOp>();
+            op->op = in.string();
+            op->operand = read_expression(in, arena);
+            return op;
+        }
+        case NodeKind::Call: {
+            auto* call = arena.create<Call>();
+            call->func = read_expression(in, arena);
+            std::uint64_t count = in.varint();
+            call->args.reserve(count);
+            for (std::uint64_t i = 0; i < count; ++i) {
+                call->args.push_back(read_expression(in, arena));
+            }
+            return call;
+        }
+        case NodeKind::Attribute: {
+            auto* attr = arena.create<Attribute>();
+            attr->value = read_expression(in, arena);
+            attr->attr = intern::intern(in.string());
+            return attr;
+        }
+        case NodeKind::ListLiteral: {
+            auto* list = arena.create<ListLiteral>();
+            std::uint64_t count = in.varint();
+            list->elements.reserve(count);
+            for (std::uint64_t i = 0; i < count; ++i) {
+                list->elements.push_back(read_expression(in, arena));
+            }
+            return list;
+        }
+        case NodeKind::DictLiteral: {
+            auto* dict = arena.create<DictLiteral>();
+            std::uint64_t count = in.varint();
+            dict->pairs.reserve(count);
+            for (std::uint64_t i = 0; i < count; ++i) {
+                auto key = read_expression(in, arena);
+                auto value = read_expression(in, arena);
+                dict->pairs.emplace_back(key, value);
+            }
+            return dict;
+        }
+    }
+    throw std::runtime_error("Corrupt .trifb module: unknown node kind");
+}
+
+}  // namespace
+
+std::string serialize(const ast::ModulePtr& module) {
+    Writer out;
+    out.byte(kMagic[0]);
+    out.byte(kMagic[1]);
+    out.byte(kMagic[2]);
+    out.byte(kMagic[3]);
+    out.varint(kVersion);
+    write_node(out, module);
+    return out.take();
+}
+
+ast::ModulePtr deserialize(std::string_view data, ast::Arena& arena) {
+    if (data.size() < 4 || std::memcmp(data.data(), kMagic, 4) != 0) {
+        throw std::runtime_error("Not a .trifb module (bad magic)");
+    }
+    Reader in(data.substr(4));
+    std::uint64_t version = in.varint();
+    if (version != kVersion) {
+        throw std::runtime_error("Unsupported .trifb version: " + std::to_string(version));
+    }
+    NodePtr node = read_node(in, arena);
+    if (node->kind != NodeKind::Module) {
+        throw std::runtime_error("Corrupt .trifb module: root is not a module");
+    }
+    return static_cast<Module*>(node);
+}
+
+}  // namespace trif::astio
@@ -0,0 +1,104 @@
+#include "trif/capi.h"
+
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "trif/compiler.hpp"
+#include "trif/diagnostics.hpp"
+
+// The handles the C ABI hands out. Both are plain structs in the global
+// namespace so the typedef names in capi.h resolve to them directly; all
+// C++ machinery stays behind the opaque pointers.
+
+struct trifc_session {
+    trif::compiler::Compiler compiler;
+    trif::compiler::CompileOptions defaults;
+};
+
+struct trifc_result {
+    std::string output;
+    bool has_output = false;
+    // Pre-rendered so trifc_result_diagnostic can return stable pointers.
+    std::vector<std::string> diagnostics;
+};
+
+extern "C" {
+
+trifc_session* trifc_session_new(const char* cache_dir) {
+    auto* session = new (std::nothrow) trifc_session();
+    if (session != nullptr && cache_dir != nullptr) {
+        session->defaults.cache_dir = std::string(cache_dir);
+    }
+    return session;
+}
+
+void trifc_session_free(trifc_session* session) {
+    delete session;
+}
+
+trifc_result* trifc_compile(trifc_session* session, const char* source, size_t length,
+                            const char* target, int optimize) {
+    auto* result = new (std::nothrow) trifc_result();
+    if (result == nullptr) {
+        return nullptr;
+    }
+    if (session == nullptr || source == nullptr || target == nullptr) {
+        result->diagnostics.emplace_back("Invalid argument to trifc_compile");
+        return result;
+    }
+
+    trif::compiler::CompileOptions options = session->defaults;
+    options.target = target;
+    options.optimize = optimize != 0;
+    try {
+        auto compiled =
+            session->compiler.compile_source(std::string_view(source, length), options);
+        if (compiled.diagnostics.empty() && compiled.output_text.has_value()) {
+            result->output = std::move(*compiled.output_text);
+            result->has_output = true;
+        } else {
+            for (const auto& diagnostic : compiled.diagnostics) {
+                result->diagnostics.push_back(trif::diagnostics::render(diagnostic));
+            }
+        }
+    } catch (const std::exception& exc) {
+        // Unknown targets and internal failures throw rather than record;
+        // fold them into the diagnostic list so the ABI stays exception-free.
+        result->diagnostics.emplace_back(exc.what());
+    }
+    return result;
+}
+
+const char* trifc_result_output(const trifc_result* result, size_t* out_length) {
+    if (result == nullptr || !result->has_output) {
+        if (out_length != nullptr) {
+            *out_length = 0;
+        }
+        return nullptr;
+    }
+    if (out_length != nullptr) {
+        *out_length = result->output.size();
+    }
+    return result->output.c_str();
+}
+
+size_t trifc_result_diagnostic_count(const trifc_result* result) {
+    return result == nullptr ? 0 : result->diagnostics.size();
+}
+
+const char* trifc_result_diagnostic(const trifc_result* result, size_t index) {
+    if (result == nullptr || index >= result->diagnostics.size()) {
+        return nullptr;
+    }
+    return result->diagnostics[index].c_str();
+}
+
+void trifc_result_free(trifc_result* result) {
+    delete result;
+}
+
+}  // extern "C"
@@ -1,9 +1,17 @@
 #include "trif/codegen.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <iomanip>
 #include <memory>
+#include <mutex>
+#include <ostream>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "trif/ast.hpp"
@@ -13,49 +21,145 @@ namespace trif::codegen {
 namespace {
 
 using namespace trif::ast;
+using intern::spelling;
 
+// Formats a numeric literal the way trif_lang/codegen.py does: integral
+// values print with no fraction or exponent, everything else with the fewest
+// digits that read back as exactly `value`. A default-precision stream would
+// turn 1234567 into 1.23457e+06.
+std::string format_number(double value) {
+    if (std::isfinite(value) && std::fabs(value) < 1e15 && value == std::floor(value)) {
+        return std::to_string(static_cast<long long>(value));
+    }
+    for (int precision = 1; precision <= 17; ++precision) {
+        std::ostringstream oss;
+        oss << std::setprecision(precision) << value;
+        std::string text = oss.str();
+        if (std::stod(text) == value) {
+            return text;
+        }
+    }
+    std::ostringstream oss;
+    oss << std::setprecision(17) << value;  // inf/nan land here
+    return oss.str();
+}
+
+// Comma-joins interned parameter names for a signature.
+std::string join_params(const std::vector<intern::Symbol>& params, const std::string& sep) {
+    std::string result;
+    for (std::size_t i = 0; i < params.size(); ++i) {
+        if (i != 0) {
+            result += sep;
+        }
+        result += spelling(params[i]);
+    }
+    return result;
+}
+
+// Append-only output buffer with a cached indent prefix. Without a sink the
+// whole output accumulates in one string handed out by take(); with a sink,
+// full chunks are flushed to the stream so no whole-program string is built.
 class IndentedEmitter {
    public:
-    void emit(const std::string& line) { stream_ << std::string(indent_ * 4, ' ') << line << '\n'; }
-    void indent() { ++indent_; }
+    IndentedEmitter() = default;
+    explicit IndentedEmitter(std::ostream* sink) : sink_(sink) {}
+
+    void emit(std::string_view line) {
+        buffer_.append(indent_prefix_);
+        buffer_.append(line);
+        buffer_.push_back('\n');
+        if (sink_ && buffer_.size() >= kFlushThreshold) {
+            flush();
+        }
+    }
+
+    void indent() { indent_prefix_.append(4, ' '); }
+
     void dedent() {
-        if (indent_ == 0) {
+        if (indent_prefix_.empty()) {
             throw std::runtime_error("Indentation underflow");
         }
-        --indent_;
+        indent_prefix_.resize(indent_prefix_.size() - 4);
+    }
+
+    void flush() {
+        if (sink_ && !buffer_.empty()) {
+            sink_->write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+            buffer_.clear();
+        }
     }
-    std::string str() const { return stream_.str(); }
+
+    std::string take() { return std::move(buffer_); }
 
    private:
-    std::ostringstream stream_;
-    int indent_ = 0;
+    static constexpr std::size_t kFlushThreshold = 64 * 1024;
+
+    std::string buffer_;
+    std::string indent_prefix_;
+    std::ostream* sink_ = nullptr;
 };
 
-class PythonVisitor {
+// The bootstrap every standalone Python output starts with: put the
+// directory holding the trif_lang package on sys.path, then bind the
+// runtime. Shared-preamble builds write these lines once as _trif_boot.py
+// (python_boot_module()) and each module imports that instead.
+void emit_python_bootstrap(IndentedEmitter& emitter) {
+    emitter.emit("import pathlib");
+    emitter.emit("import sys");
+    emitter.emit("_trif_origin = pathlib.Path(__file__).resolve().parent if '__file__' in globals() else pathlib.Path.cwd()");
+    emitter.emit("for _candidate in (_trif_origin, _trif_origin.parent):");
+    emitter.indent();
+    emitter.emit("candidate_pkg = _candidate / 'trif_lang'");
+    emitter.emit("if candidate_pkg.exists():");
+    emitter.indent();
+    emitter.emit("if str(_candidate) not in sys.path:");
+    emitter.indent();
+    emitter.emit("sys.path.insert(0, str(_candidate))");
+    emitter.dedent();
+    emitter.emit("break");
+    emitter.dedent();
+    emitter.dedent();
+    emitter.emit("from trif_lang.runtime import runtime");
+}
+
+class PythonVisitor : public StatementVisitor<PythonVisitor> {
+    friend StatementVisitor<PythonVisitor>;
+
    public:
-    std::string generate(const ModulePtr& module) {
-        emitter_.emit("import pathlib");
-        emitter_.emit("import sys");
-        emitter_.emit("_trif_origin = pathlib.Path(__file__).resolve().parent if '__file__' in globals() else pathlib.Path.cwd()");
-        emitter_.emit("for _candidate in (_trif_origin, _trif_origin.parent):");
-        emitter_.indent();
-        emitter_.emit("candidate_pkg = _candidate / 'trif_lang'");
-        emitter_.emit("if candidate_pkg.exists():");
-        emitter_.indent();
-        emitter_.emit("if str(_candidate) not in sys.path:");
-        emitter_.indent();
-        emitter_.emit("sys.path.insert(0, str(_candidate))");
-        emitter_.dedent();
-        emitter_.emit("break");
-        emitter_.dedent();
-        emitter_.dedent();
-        emitter_.emit("from trif_lang.runtime import runtime");
-        emitter_.emit("__trif_exports__ = {}");
-        emitter_.emit("__trif_default_export__ = None");
-        emitter_.emit("");
+    explicit PythonVisitor(bool shared_preamble = false) : shared_preamble_(shared_preamble) {}
+    PythonVisitor(std::ostream* sink, bool shared_preamble)
+        : emitter_(sink), shared_preamble_(shared_preamble) {}
+
+    void emit_module(const ModulePtr& module) {
+        emit_prologue();
+        enter_declarations();
         for (const auto& stmt : module->body) {
             visit(stmt);
         }
+        emit_epilogue(module);
+    }
+
+    // The prologue/declarations/epilogue split mirrors the parallel
+    // generator, which renders each top-level statement with its own
+    // visitor and stitches the pieces back together in source order.
+    void emit_prologue() {
+        if (shared_preamble_) {
+            // One cached import replaces the bootstrap below; _trif_boot.py
+            // (python_boot_module()) does the path probing once per program.
+            emitter_.emit("from _trif_boot import runtime");
+        } else {
+            emit_python_bootstrap(emitter_);
+        }
+        emitter_.emit("__trif_exports__ = {}");
+        emitter_.emit("__trif_default_export__ = None");
+        emitter_.emit("");
+    }
+
+    // Top-level declarations render at column zero; the C++ target
+    // overrides this to step into main()'s scope.
+    void enter_declarations() {}
+
+    void emit_epilogue(const ModulePtr&) {
         emitter_.emit("");
         emitter_.emit("runtime.register_module_exports(__name__, __trif_exports__, __trif_default_export__)");
         emitter_.emit("");
@@ -63,63 +167,32 @@ class PythonVisitor {
         emitter_.indent();
         emitter_.emit("runtime.default_entry_point(locals())");
         emitter_.dedent();
-        return emitter_.str();
     }
 
+    // Starts the temporary counter at `base` so a visitor rendering one
+    // declaration numbers its temps exactly as the sequential walk would.
+    void seed_temps(int base) { temp_index_ = base; }
+
+    std::string take() { return emitter_.take(); }
+    void flush() { emitter_.flush(); }
+
    private:
     IndentedEmitter emitter_;
     int temp_index_ = 0;
 
     std::string temp(const std::string& prefix) { return "__trif_" + prefix + "_" + std::to_string(temp_index_++); }
 
-    void visit(const NodePtr& node) {
-        switch (node->kind) {
-            case NodeKind::Import:
-                visit_import(std::static_pointer_cast<Import>(node));
-                break;
-            case NodeKind::ImportFrom:
-                visit_import_from(std::static_pointer_cast<ImportFrom>(node));
-                break;
-            case NodeKind::Let:
-                visit_let(std::static_pointer_cast<Let>(node));
-                break;
-            case NodeKind::Assign:
-                visit_assign(std::static_pointer_cast<Assign>(node));
-                break;
-            case NodeKind::FunctionDef:
-                visit_function_def(std::static_pointer_cast<FunctionDef>(node));
-                break;
-            case NodeKind::Return:
-                visit_return(std::static_pointer_cast<Return>(node));
-                break;
-            case NodeKind::ExportNames:
-                visit_export_names(std::static_pointer_cast<ExportNames>(node));
-                break;
-            case NodeKind::ExportDefault:
-                visit_export_default(std::static_pointer_cast<ExportDefault>(node));
-                break;
-            case NodeKind::If:
-                visit_if(std::static_pointer_cast<If>(node));
-                break;
-            case NodeKind::While:
-                visit_while(std::static_pointer_cast<While>(node));
-                break;
-            case NodeKind::For:
-                visit_for(std::static_pointer_cast<For>(node));
-                break;
-            case NodeKind::Spawn:
-                visit_spawn(std::static_pointer_cast<Spawn>(node));
-                break;
-            default:
-                if (std::dynamic_pointer_cast<Expression>(node)) {
-                    emitter_.emit(render_expression(std::static_pointer_cast<Expression>(node)));
-                } else {
-                    throw std::runtime_error("Unsupported node in Python generator");
-                }
-        }
+    bool shared_preamble_ = false;
+
+    void visit_expression_statement(const ExpressionPtr node) {
+        emitter_.emit(render_expression(node));
+    }
+
+    [[noreturn]] void visit_unsupported(const NodePtr&) {
+        throw std::runtime_error("Unsupported node in Python generator");
     }
 
-    void visit_import(const std::shared_ptr<Import>& node) {
+    void visit_import(const Import* node) {
         std::string target = node->alias.value_or(node->module);
         for (auto& ch : target) {
             if (ch == '.' || ch == '-') {
@@ -129,7 +202,7 @@ class PythonVisitor {
         emitter_.emit(target + " = runtime.import_module('" + node->module + "')");
     }
 
-    void visit_import_from(const std::shared_ptr<ImportFrom>& node) {
+    void visit_import_from(const ImportFrom* node) {
         std::string temp_name = temp("import");
         emitter_.emit(temp_name + " = runtime.import_module('" + node->module + "')");
         if (node->namespace_name) {
@@ -143,26 +216,26 @@ class PythonVisitor {
         }
     }
 
-    void visit_let(const std::shared_ptr<Let>& node) {
-        std::string assignment = node->name + " = " + render_expression(node->value);
+    void visit_let(const Let* node) {
+        std::string assignment = spelling(node->name) + " = " + render_expression(node->value);
         if (!node->mutable_flag) {
             assignment += "  # const";
         }
         emitter_.emit(assignment);
         if (node->exported) {
-            emitter_.emit("__trif_exports__['" + node->name + "'] = " + node->name);
+            emitter_.emit("__trif_exports__['" + spelling(node->name) + "'] = " + spelling(node->name));
         }
         if (node->is_default) {
-            emitter_.emit("__trif_default_export__ = " + node->name);
+            emitter_.emit("__trif_default_export__ = " + spelling(node->name));
         }
     }
 
-    void visit_assign(const std::shared_ptr<Assign>& node) {
+    void visit_assign(const Assign* node) {
         emitter_.emit(render_expression(node->target) + " = " + render_expression(node->value));
     }
 
-    void visit_function_def(const std::shared_ptr<FunctionDef>& node) {
-        emitter_.emit("def " + node->name + "(" + join(node->params, ", ") + "):");
+    void visit_function_def(const FunctionDef* node) {
+        emitter_.emit("def " + spelling(node->name) + "(" + join_params(node->params, ", ") + "):");
         emitter_.indent();
         if (node->body.empty()) {
             emitter_.emit("return None");
@@ -176,15 +249,15 @@ class PythonVisitor {
         }
         emitter_.dedent();
         if (node->exported) {
-            emitter_.emit("__trif_exports__['" + node->name + "'] = " + node->name);
+            emitter_.emit("__trif_exports__['" + spelling(node->name) + "'] = " + spelling(node->name));
         }
         if (node->is_default) {
-            emitter_.emit("__trif_default_export__ = " + node->name);
+            emitter_.emit("__trif_default_export__ = " + spelling(node->name));
         }
         emitter_.emit("");
     }
 
-    void visit_return(const std::shared_ptr<Return>& node) {
+    void visit_return(const Return* node) {
         if (!node->value) {
             emitter_.emit("return None");
         } else {
@@ -192,7 +265,7 @@ class PythonVisitor {
         }
     }
 
-    void visit_export_names(const std::shared_ptr<ExportNames>& node) {
+    void visit_export_names(const ExportNames* node) {
         if (node->source) {
             std::string temp_name = temp("export");
             emitter_.emit(temp_name + " = runtime.import_module('" + *node->source + "')");
@@ -206,11 +279,11 @@ class PythonVisitor {
         }
     }
 
-    void visit_export_default(const std::shared_ptr<ExportDefault>& node) {
+    void visit_export_default(const ExportDefault* node) {
         emitter_.emit("__trif_default_export__ = " + render_expression(node->value));
     }
 
-    void visit_if(const std::shared_ptr<If>& node) {
+    void visit_if(const If* node) {
         emitter_.emit("if " + render_expression(node->test) + ":");
         emitter_.indent();
         for (const auto& stmt : node->body) {
@@ -227,7 +300,7 @@ class PythonVisitor {
         }
     }
 
-    void visit_while(const std::shared_ptr<While>& node) {
+    void visit_while(const While* node) {
         emitter_.emit("while " + render_expression(node->test) + ":");
         emitter_.indent();
         for (const auto& stmt : node->body) {
@@ -236,8 +309,8 @@ class PythonVisitor {
         emitter_.dedent();
     }
 
-    void visit_for(const std::shared_ptr<For>& node) {
-        emitter_.emit("for " + node->target + " in " + render_expression(node->iterator) + ":");
+    void visit_for(const For* node) {
+        emitter_.emit("for " + spelling(node->target) + " in " + render_expression(node->iterator) + ":");
         emitter_.indent();
         for (const auto& stmt : node->body) {
             visit(stmt);
@@ -245,7 +318,7 @@ class PythonVisitor {
         emitter_.dedent();
     }
 
-    void visit_spawn(const std::shared_ptr<Spawn>& node) {
+    void visit_spawn(const Spawn* node) {
         emitter_.emit("runtime.spawn(" + render_expression(node->call) + ")");
     }
 
@@ -263,28 +336,35 @@ class PythonVisitor {
     std::string render_expression(const ExpressionPtr& expr) {
         switch (expr->kind) {
             case NodeKind::Name:
-                return std::static_pointer_cast<Name>(expr)->id;
-            case NodeKind::Number: {
-                std::ostringstream oss;
-                oss << std::static_pointer_cast<Number>(expr)->value;
-                return oss.str();
-            }
+                return spelling(static_cast<Name*>(expr)->id);
+            case NodeKind::Number:
+                return format_number(static_cast<Number*>(expr)->value);
             case NodeKind::String:
-                return repr_string(std::static_pointer_cast<String>(expr)->value);
+                return repr_string(static_cast<String*>(expr)->value);
             case NodeKind::Boolean:
-                return std::static_pointer_cast<Boolean>(expr)->value ? "True" : "False";
+                return static_cast<Boolean*>(expr)->value ? "True" : "False";
             case NodeKind::Null:
                 return "None";
             case NodeKind::BinaryOp: {
-                auto node = std::static_pointer_cast<BinaryOp>(expr);
-                return render_expression(node->left) + " " + node->op + " " + render_expression(node->right);
+                // Trif's &&/||/! spell differently in Python; parenthesized
+                // like trif_lang/codegen.py so source precedence survives.
+                auto node = static_cast<BinaryOp*>(expr);
+                std::string op = node->op;
+                if (op == "&&") {
+                    op = "and";
+                } else if (op == "||") {
+                    op = "or";
+                }
+                return "(" + render_expression(node->left) + " " + op + " " +
+                       render_expression(node->right) + ")";
             }
             case NodeKind::UnaryOp: {
-                auto node = std::static_pointer_cast<UnaryOp>(expr);
-                return node->op + render_expression(node->operand);
+                auto node = static_cast<UnaryOp*>(expr);
+                std::string op = node->op == "!" ? "not " : node->op;
+                return "(" + op + render_expression(node->operand) + ")";
             }
             case NodeKind::Call: {
-                auto node = std::static_pointer_cast<Call>(expr);
+                auto node = static_cast<Call*>(expr);
                 std::vector<std::string> args;
                 for (const auto& arg : node->args) {
                     args.push_back(render_expression(arg));
@@ -292,11 +372,11 @@ class PythonVisitor {
                 return render_expression(node->func) + "(" + join(args, ", ") + ")";
             }
             case NodeKind::Attribute: {
-                auto node = std::static_pointer_cast<Attribute>(expr);
-                return render_expression(node->value) + "." + node->attr;
+                auto node = static_cast<Attribute*>(expr);
+                return render_expression(node->value) + "." + spelling(node->attr);
             }
             case NodeKind::ListLiteral: {
-                auto node = std::static_pointer_cast<ListLiteral>(expr);
+                auto node = static_cast<ListLiteral*>(expr);
                 std::vector<std::string> values;
                 for (const auto& element : node->elements) {
                     values.push_back(render_expression(element));
@@ -304,7 +384,7 @@ class PythonVisitor {
                 return "[" + join(values, ", ") + "]";
             }
             case NodeKind::DictLiteral: {
-                auto node = std::static_pointer_cast<DictLiteral>(expr);
+                auto node = static_cast<DictLiteral*>(expr);
                 std::vector<std::string> pairs;
                 for (const auto& [key, value] : node->pairs) {
                     pairs.push_back(render_expression(key) + ": " + render_expression(value));
@@ -316,17 +396,20 @@ class PythonVisitor {
         }
     }
 
+    // Matches Python repr(): single-quoted unless the value holds a single
+    // quote and no double quote, escaping only the chosen delimiter.
     std::string repr_string(const std::string& value) {
+        char quote = '\'';
+        if (value.find('\'') != std::string::npos && value.find('"') == std::string::npos) {
+            quote = '"';
+        }
         std::ostringstream oss;
-        oss << '"';
+        oss << quote;
         for (char c : value) {
             switch (c) {
                 case '\\':
                     oss << "\\\\";
                     break;
-                case '"':
-                    oss << "\\\"";
-                    break;
                 case '\n':
                     oss << "\\n";
                     break;
@@ -337,87 +420,70 @@ class PythonVisitor {
                     oss << "\\r";
                     break;
                 default:
-                    oss << c;
+                    if (c == quote) {
+                        oss << '\\' << quote;
+                    } else {
+                        oss << c;
+                    }
                     break;
             }
         }
-        oss << '"';
+        oss << quote;
         return oss.str();
     }
 };
 
-class JavaScriptVisitor {
+class JavaScriptVisitor : public StatementVisitor<JavaScriptVisitor> {
+    friend StatementVisitor<JavaScriptVisitor>;
+
    public:
-    std::string generate(const ModulePtr& module) {
+    JavaScriptVisitor() = default;
+    explicit JavaScriptVisitor(std::ostream* sink) : emitter_(sink) {}
+
+    void emit_module(const ModulePtr& module) {
+        emit_prologue();
+        enter_declarations();
+        for (const auto& stmt : module->body) {
+            visit(stmt);
+        }
+        emit_epilogue(module);
+    }
+
+    void emit_prologue() {
         emitter_.emit("import { runtime } from '@trif/lang/runtime.js'");
         emitter_.emit("const __trif_exports__ = new Map();");
         emitter_.emit("let __trif_default_export__ = null;");
         emitter_.emit("");
-        for (const auto& stmt : module->body) {
-            visit(stmt);
-        }
+    }
+
+    void enter_declarations() {}
+
+    void emit_epilogue(const ModulePtr&) {
         emitter_.emit("");
         emitter_.emit("export default __trif_default_export__;");
         emitter_.emit("export const exports = __trif_exports__;");
-        return emitter_.str();
     }
 
+    std::string take() { return emitter_.take(); }
+    void flush() { emitter_.flush(); }
+
    private:
     IndentedEmitter emitter_;
 
-    void visit(const NodePtr& node) {
-        switch (node->kind) {
-            case NodeKind::Import:
-                visit_import(std::static_pointer_cast<Import>(node));
-                break;
-            case NodeKind::ImportFrom:
-                visit_import_from(std::static_pointer_cast<ImportFrom>(node));
-                break;
-            case NodeKind::Let:
-                visit_let(std::static_pointer_cast<Let>(node));
-                break;
-            case NodeKind::Assign:
-                visit_assign(std::static_pointer_cast<Assign>(node));
-                break;
-            case NodeKind::FunctionDef:
-                visit_function_def(std::static_pointer_cast<FunctionDef>(node));
-                break;
-            case NodeKind::Return:
-                visit_return(std::static_pointer_cast<Return>(node));
-                break;
-            case NodeKind::ExportNames:
-                visit_export_names(std::static_pointer_cast<ExportNames>(node));
-                break;
-            case NodeKind::ExportDefault:
-                visit_export_default(std::static_pointer_cast<ExportDefault>(node));
-                break;
-            case NodeKind::If:
-                visit_if(std::static_pointer_cast<If>(node));
-                break;
-            case NodeKind::While:
-                visit_while(std::static_pointer_cast<While>(node));
-                break;
-            case NodeKind::For:
-                visit_for(std::static_pointer_cast<For>(node));
-                break;
-            case NodeKind::Spawn:
-                visit_spawn(std::static_pointer_cast<Spawn>(node));
-                break;
-            default:
-                if (std::dynamic_pointer_cast<Expression>(node)) {
-                    emitter_.emit(render_expression(std::static_pointer_cast<Expression>(node)) + ';');
-                } else {
-                    throw std::runtime_error("Unsupported node in JS generator");
-                }
-        }
+    void visit_expression_statement(const ExpressionPtr node) {
+        emitter_.emit(render_expression(node) + ';');
+    }
+
+    [[noreturn]] void visit_unsupported(const NodePtr&) {
+        throw std::runtime_error("Unsupported node in JS generator");
     }
 
-    void visit_import(const std::shared_ptr<Import>& node) {
+    void visit_import(const Import* node) {
         std::string target = node->alias.value_or(node->module);
         emitter_.emit("const " + target + " = await runtime.importModule('" + node->module + "');");
     }
 
-    void visit_import_from(const std::shared_ptr<ImportFrom>& node) {
+    void visit_import_from(const ImportFrom* node) {
         emitter_.emit("const __mod = await runtime.importModule('" + node->module + "');");
         if (node->namespace_name) {
             emitter_.emit("const " + *node->namespace_name + " = __mod;");
@@ -430,23 +496,23 @@ class JavaScriptVisitor {
         }
     }
 
-    void visit_let(const std::shared_ptr<Let>& node) {
+    void visit_let(const Let* node) {
         std::string keyword = node->mutable_flag ? "let" : "const";
-        emitter_.emit(keyword + " " + node->name + " = " + render_expression(node->value) + ";");
+        emitter_.emit(keyword + " " + spelling(node->name) + " = " + render_expression(node->value) + ";");
         if (node->exported) {
-            emitter_.emit("__trif_exports__.set('" + node->name + "', " + node->name + ");");
+            emitter_.emit("__trif_exports__.set('" + spelling(node->name) + "', " + spelling(node->name) + ");");
         }
         if (node->is_default) {
-            emitter_.emit("__trif_default_export__ = " + node->name + ";");
+            emitter_.emit("__trif_default_export__ = " + spelling(node->name) + ";");
         }
     }
 
-    void visit_assign(const std::shared_ptr<Assign>& node) {
+    void visit_assign(const Assign* node) {
         emitter_.emit(render_expression(node->target) + " = " + render_expression(node->value) + ";");
     }
 
-    void visit_function_def(const std::shared_ptr<FunctionDef>& node) {
-        emitter_.emit("function " + node->name + "(" + join(node->params, ", ") + ") {");
+    void visit_function_def(const FunctionDef* node) {
+        emitter_.emit("function " + spelling(node->name) + "(" + join_params(node->params, ", ") + ") {");
         emitter_.indent();
         if (node->body.empty()) {
             emitter_.emit("return null;");
@@ -459,15 +525,15 @@ class JavaScriptVisitor {
         emitter_.dedent();
         emitter_.emit("}");
         if (node->exported) {
-            emitter_.emit("__trif_exports__.set('" + node->name + "', " + node->name + ");");
+            emitter_.emit("__trif_exports__.set('" + spelling(node->name) + "', " + spelling(node->name) + ");");
         }
         if (node->is_default) {
-            emitter_.emit("__trif_default_export__ = " + node->name + ";");
+            emitter_.emit("__trif_default_export__ = " + spelling(node->name) + ";");
         }
         emitter_.emit("");
     }
 
-    void visit_return(const std::shared_ptr<Return>& node) {
+    void visit_return(const Return* node) {
         if (!node->value) {
             emitter_.emit("return null;");
         } else {
@@ -475,7 +541,7 @@ class JavaScriptVisitor {
         }
     }
 
-    void visit_export_names(const std::shared_ptr<ExportNames>& node) {
+    void visit_export_names(const ExportNames* node) {
         if (node->source) {
             emitter_.emit("const __mod = await runtime.importModule('" + *node->source + "');");
             for (const auto& [source, alias] : node->names) {
@@ -488,11 +554,11 @@ class JavaScriptVisitor {
         }
     }
 
-    void visit_export_default(const std::shared_ptr<ExportDefault>& node) {
+    void visit_export_default(const ExportDefault* node) {
         emitter_.emit("__trif_default_export__ = " + render_expression(node->value) + ";");
     }
 
-    void visit_if(const std::shared_ptr<If>& node) {
+    void visit_if(const If* node) {
         emitter_.emit("if (" + render_expression(node->test) + ") {");
         emitter_.indent();
         for (const auto& stmt : node->body) {
@@ -510,7 +576,7 @@ class JavaScriptVisitor {
         emitter_.emit("}");
     }
 
-    void visit_while(const std::shared_ptr<While>& node) {
+    void visit_while(const While* node) {
         emitter_.emit("while (" + render_expression(node->test) + ") {");
         emitter_.indent();
         for (const auto& stmt : node->body) {
@@ -520,8 +586,8 @@ class JavaScriptVisitor {
         emitter_.emit("}");
     }
 
-    void visit_for(const std::shared_ptr<For>& node) {
-        emitter_.emit("for (const " + node->target + " of " + render_expression(node->iterator) + ") {");
+    void visit_for(const For* node) {
+        emitter_.emit("for (const " + spelling(node->target) + " of " + render_expression(node->iterator) + ") {");
         emitter_.indent();
         for (const auto& stmt : node->body) {
             visit(stmt);
@@ -530,7 +596,7 @@ class JavaScriptVisitor {
         emitter_.emit("}");
     }
 
-    void visit_spawn(const std::shared_ptr<Spawn>& node) {
+    void visit_spawn(const Spawn* node) {
         emitter_.emit("runtime.spawn(" + render_expression(node->call) + ");");
     }
 
@@ -548,28 +614,26 @@ class JavaScriptVisitor {
     std::string render_expression(const ExpressionPtr& expr) {
         switch (expr->kind) {
             case NodeKind::Name:
-                return std::static_pointer_cast<Name>(expr)->id;
-            case NodeKind::Number: {
-                std::ostringstream oss;
-                oss << std::static_pointer_cast<Number>(expr)->value;
-                return oss.str();
-            }
+                return spelling(static_cast<Name*>(expr)->id);
+            case NodeKind::Number:
+                return format_number(static_cast<Number*>(expr)->value);
             case NodeKind::String:
-                return repr_string(std::static_pointer_cast<String>(expr)->value);
+                return repr_string(static_cast<String*>(expr)->value);
             case NodeKind::Boolean:
-                return std::static_pointer_cast<Boolean>(expr)->value ? "true" : "false";
+                return static_cast<Boolean*>(expr)->value ? "true" : "false";
             case NodeKind::Null:
                 return "null";
             case NodeKind::BinaryOp: {
-                auto node = std::static_pointer_cast<BinaryOp>(expr);
-                return render_expression(node->left) + " " + node->op + " " + render_expression(node->right);
+                auto node = static_cast<BinaryOp*>(expr);
+                return "(" + render_expression(node->left) + " " + node->op + " " +
+                       render_expression(node->right) + ")";
             }
             case NodeKind::UnaryOp: {
-                auto node = std::static_pointer_cast<UnaryOp>(expr);
-                return node->op + render_expression(node->operand);
+                auto node = static_cast<UnaryOp*>(expr);
+                return "(" + node->op + render_expression(node->operand) + ")";
             }
             case NodeKind::Call: {
-                auto node = std::static_pointer_cast<Call>(expr);
+                auto node = static_cast<Call*>(expr);
                 std::vector<std::string> args;
                 for (const auto& arg : node->args) {
                     args.push_back(render_expression(arg));
@@ -577,11 +641,11 @@ class JavaScriptVisitor {
                 return render_expression(node->func) + "(" + join(args, ", ") + ")";
             }
             case NodeKind::Attribute: {
-                auto node = std::static_pointer_cast<Attribute>(expr);
-                return render_expression(node->value) + "." + node->attr;
+                auto node = static_cast<Attribute*>(expr);
+                return render_expression(node->value) + "." + spelling(node->attr);
             }
             case NodeKind::ListLiteral: {
-                auto node = std::static_pointer_cast<ListLiteral>(expr);
+                auto node = static_cast<ListLiteral*>(expr);
                 std::vector<std::string> values;
                 for (const auto& element : node->elements) {
                     values.push_back(render_expression(element));
@@ -589,7 +653,7 @@ class JavaScriptVisitor {
                 return "[" + join(values, ", ") + "]";
             }
             case NodeKind::DictLiteral: {
-                auto node = std::static_pointer_cast<DictLiteral>(expr);
+                auto node = static_cast<DictLiteral*>(expr);
                 std::vector<std::string> pairs;
                 for (const auto& [key, value] : node->pairs) {
                     pairs.push_back(render_expression(key) + ": " + render_expression(value));
@@ -631,16 +695,553 @@ class JavaScriptVisitor {
     }
 };
 
+class CppVisitor : public StatementVisitor<CppVisitor> {
+    friend StatementVisitor<CppVisitor>;
+
+   public:
+    CppVisitor() = default;
+    explicit CppVisitor(std::ostream* sink) : emitter_(sink) {}
+
+    void emit_module(const ModulePtr& module) {
+        emit_prologue();
+        enter_declarations();
+        for (const auto& stmt : module->body) {
+            visit(stmt);
+        }
+        emit_epilogue(module);
+    }
+
+    void emit_prologue() {
+        emitter_.emit("#include <trif/runtime.hpp>");
+        emitter_.emit("");
+        emitter_.emit("using trif::runtime::Runtime;");
+        emitter_.emit("using trif::runtime::Value;");
+        emitter_.emit("using trif::runtime::ValueDict;");
+        emitter_.emit("using trif::runtime::ValueList;");
+        emitter_.emit("");
+        emitter_.emit("int main() {");
+        emitter_.indent();
+        emitter_.emit("Runtime runtime;");
+        emitter_.emit("Value __trif_exports__ = runtime.create_module();");
+        emitter_.emit("Value __trif_default_export__ = Value();");
+        emitter_.emit("");
+        emitter_.dedent();
+    }
+
+    // Unlike the scripting targets, declarations and the epilogue render
+    // one level deep, inside main()'s scope.
+    void enter_declarations() { emitter_.indent(); }
+
+    void emit_epilogue(const ModulePtr& module) {
+        emitter_.emit("");
+        emitter_.emit("runtime.register_module(__trif_exports__, __trif_default_export__);");
+        // Mirrors the python epilogue's default_entry_point: a top-level
+        // `main` runs after module registration.
+        if (defines_main(module)) {
+            emitter_.emit("runtime.call(main, ValueList{});");
+        }
+        emitter_.emit("return 0;");
+        emitter_.dedent();
+        emitter_.emit("}");
+    }
+
+    // Starts the temporary counter at `base` so a visitor rendering one
+    // declaration numbers its temps exactly as the sequential walk would.
+    void seed_temps(int base) { temp_index_ = base; }
+
+    std::string take() { return emitter_.take(); }
+    void flush() { emitter_.flush(); }
+
+   private:
+    IndentedEmitter emitter_;
+    int temp_index_ = 0;
+
+    std::string temp(const std::string& prefix) { return "__trif_" + prefix + "_" + std::to_string(temp_index_++); }
+
+    static bool defines_main(const ModulePtr& module) {
+        for (const auto& stmt : module->body) {
+            if (stmt->kind == NodeKind::FunctionDef &&
+                spelling(static_cast<FunctionDef*>(stmt)->name) == "main") {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void visit_expression_statement(const ExpressionPtr node) {
+        emitter_.emit(render_expression(node) + ";");
+    }
+
+    [[noreturn]] void visit_unsupported(const NodePtr&) {
+        throw std::runtime_error("Unsupported node in C++ generator");
+    }
+
+    static std::string sanitize(std::string name) {
+        for (auto& ch : name) {
+            if (ch == '.' || ch == '-') {
+                ch = '_';
+            }
+        }
+        return name;
+    }
+
+    void visit_import(const Import* node) {
+        std::string target = sanitize(node->alias.value_or(node->module));
+        emitter_.emit("Value " + target + " = runtime.import_module(" + repr_string(node->module) + ");");
+    }
+
+    void visit_import_from(const ImportFrom* node) {
+        std::string temp_name = temp("import");
+        emitter_.emit("Value " + temp_name + " = runtime.import_module(" + repr_string(node->module) + ");");
+        if (node->namespace_name) {
+            emitter_.emit("Value " + *node->namespace_name + " = " + temp_name + ";");
+        }
+        if (node->default_name) {
+            emitter_.emit("Value " + *node->default_name + " = runtime.extract_default(" + temp_name + ");");
+        }
+        for (const auto& [source, alias] : node->names) {
+            emitter_.emit("Value " + alias + " = runtime.extract_export(" + temp_name + ", " +
+                          repr_string(source) + ");");
+        }
+    }
+
+    void visit_let(const Let* node) {
+        std::string declaration = "Value " + spelling(node->name) + " = " + render_expression(node->value) + ";";
+        if (!node->mutable_flag) {
+            declaration += "  // const";
+        }
+        emitter_.emit(declaration);
+        if (node->exported) {
+            emitter_.emit("runtime.set_export(__trif_exports__, " + repr_string(spelling(node->name)) + ", " +
+                          spelling(node->name) + ");");
+        }
+        if (node->is_default) {
+            emitter_.emit("__trif_default_export__ = " + spelling(node->name) + ";");
+        }
+    }
+
+    void visit_assign(const Assign* node) {
+        if (node->target->kind == NodeKind::Attribute) {
+            auto* attr = static_cast<Attribute*>(node->target);
+            emitter_.emit("runtime.set_attr(" + render_expression(attr->value) + ", " +
+                          repr_string(spelling(attr->attr)) + ", " + render_expression(node->value) + ");");
+            return;
+        }
+        emitter_.emit(render_expression(node->target) + " = " + render_expression(node->value) + ";");
+    }
+
+    void visit_function_def(const FunctionDef* node) {
+        // Declare first and assign so the closure can refer to itself.
+        emitter_.emit("Value " + spelling(node->name) + ";");
+        emitter_.emit(spelling(node->name) + " = Value::function([&](const ValueList& __trif_args) -> Value {");
+        emitter_.indent();
+        for (std::size_t i = 0; i < node->params.size(); ++i) {
+            emitter_.emit("Value " + spelling(node->params[i]) + " = Runtime::arg(__trif_args, " +
+                          std::to_string(i) + ");");
+        }
+        if (node->params.empty()) {
+            emitter_.emit("(void)__trif_args;");
+        }
+        for (const auto& stmt : node->body) {
+            visit(stmt);
+        }
+        emitter_.emit("return Value();");
+        emitter_.dedent();
+        emitter_.emit("});");
+        if (node->exported) {
+            emitter_.emit("runtime.set_export(__trif_exports__, " + repr_string(spelling(node->name)) + ", " +
+                          spelling(node->name) + ");");
+        }
+        if (node->is_default) {
+            emitter_.emit("__trif_default_export__ = " + spelling(node->name) + ";");
+        }
+        emitter_.emit("");
+    }
+
+    void visit_return(const Return* node) {
+        if (!node->value) {
+            emitter_.emit("return Value();");
+        } else {
+            emitter_.emit("return " + render_expression(*node->value) + ";");
+        }
+    }
+
+    void visit_export_names(const ExportNames* node) {
+        if (node->source) {
+            std::string temp_name = temp("export");
+            emitter_.emit("Value " + temp_name + " = runtime.import_module(" + repr_string(*node->source) +
+                          ");");
+            for (const auto& [source, alias] : node->names) {
+                emitter_.emit("runtime.set_export(__trif_exports__, " + repr_string(alias) +
+                              ", runtime.extract_export(" + temp_name + ", " + repr_string(source) + "));");
+            }
+        } else {
+            for (const auto& [local, alias] : node->names) {
+                emitter_.emit("runtime.set_export(__trif_exports__, " + repr_string(alias) + ", " + local +
+                              ");");
+            }
+        }
+    }
+
+    void visit_export_default(const ExportDefault* node) {
+        emitter_.emit("__trif_default_export__ = " + render_expression(node->value) + ";");
+    }
+
+    void visit_if(const If* node) {
+        emitter_.emit("if ((" + render_expression(node->test) + ").truthy()) {");
+        emitter_.indent();
+        for (const auto& stmt : node->body) {
+            visit(stmt);
+        }
+        emitter_.dedent();
+        if (!node->orelse.empty()) {
+            emitter_.emit("} else {");
+            emitter_.indent();
+            for (const auto& stmt : node->orelse) {
+                visit(stmt);
+            }
+            emitter_.dedent();
+        }
+        emitter_.emit("}");
+    }
+
+    void visit_while(const While* node) {
+        emitter_.emit("while ((" + render_expression(node->test) + ").truthy()) {");
+        emitter_.indent();
+        for (const auto& stmt : node->body) {
+            visit(stmt);
+        }
+        emitter_.dedent();
+        emitter_.emit("}");
+    }
+
+    void visit_for(const For* node) {
+        // iterate() returns a reference into its argument, so the iterable
+        // needs a named local: a temporary bound in the range-init is
+        // destroyed before the first iteration.
+        std::string iter_name = temp("iter");
+        emitter_.emit("Value " + iter_name + " = " + render_expression(node->iterator) + ";");
+        emitter_.emit("for (const Value& " + spelling(node->target) + " : runtime.iterate(" +
+                      iter_name + ")) {");
+        emitter_.indent();
+        for (const auto& stmt : node->body) {
+            visit(stmt);
+        }
+        emitter_.dedent();
+        emitter_.emit("}");
+    }
+
+    void visit_spawn(const Spawn* node) {
+        // Operands are captured by value: the task may outlive the frame
+        // that spawned it. `runtime` stays by reference; it lives until its
+        // destructor has drained the scheduler.
+        emitter_.emit("runtime.spawn([=, &runtime]() -> Value { return " +
+                      render_expression(node->call) + "; });");
+    }
+
+    std::string join(const std::vector<std::string>& values, const std::string& sep) {
+        std::ostringstream oss;
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            if (i != 0) {
+                oss << sep;
+            }
+            oss << values[i];
+        }
+        return oss.str();
+    }
+
+    std::string render_number(double value) {
+        std::string text = format_number(value);
+        if (text.find('.') == std::string::npos && text.find('e') == std::string::npos &&
+            text.find("inf") == std::string::npos && text.find("nan") == std::string::npos) {
+            text += ".0";
+        }
+        return text;
+    }
+
+    std::string render_expression(const ExpressionPtr& expr) {
+        switch (expr->kind) {
+            case NodeKind::Name:
+                return spelling(static_cast<Name*>(expr)->id);
+            case NodeKind::Number:
+                return "Value(" + render_number(static_cast<Number*>(expr)->value) + ")";
+            case NodeKind::String:
+                return "Value(" + repr_string(static_cast<String*>(expr)->value) + ")";
+            case NodeKind::Boolean:
+                return static_cast<Boolean*>(expr)->value ? "Value(true)" : "Value(false)";
+            case NodeKind::Null:
+                return "Value()";
+            case NodeKind::BinaryOp: {
+                auto node = static_cast<BinaryOp*>(expr);
+                std::string left = render_expression(node->left);
+                std::string right = render_expression(node->right);
+                if (node->op == "&&") {
+                    return "Value((" + left + ").truthy() && (" + right + ").truthy())";
+                }
+                if (node->op == "||") {
+                    return "Value((" + left + ").truthy() || (" + right + ").truthy())";
+                }
+                return "(" + left + " " + node->op + " " + right + ")";
+            }
+            case NodeKind::UnaryOp: {
+                auto node = static_cast<UnaryOp*>(expr);
+                if (node->op == "!") {
+                    return "Value(!(" + render_expression(node->operand) + ").truthy())";
+                }
+                return "(-(" + render_expression(node->operand) + "))";
+            }
+            case NodeKind::Call: {
+                auto node = static_cast<Call*>(expr);
+                std::vector<std::string> args;
+                for (const auto& arg : node->args) {
+                    args.push_back(render_expression(arg));
+                }
+                return "runtime.call(" + render_expression(node->func) + ", ValueList{" +
+                       join(args, ", ") + "})";
+            }
+            case NodeKind::Attribute: {
+                auto node = static_cast<Attribute*>(expr);
+                return "runtime.get_attr(" + render_expression(node->value) + ", " +
+                       repr_string(spelling(node->attr)) + ")";
+            }
+            case NodeKind::ListLiteral: {
+                auto node = static_cast<ListLiteral*>(expr);
+                std::vector<std::string> values;
+                for (const auto& element : node->elements) {
+                    values.push_back(render_expression(element));
+                }
+                return "Value::list(ValueList{" + join(values, ", ") + "})";
+            }
+            case NodeKind::DictLiteral: {
+                auto node = static_cast<DictLiteral*>(expr);
+                if (node->pairs.empty()) {
+                    return "Value::dict(ValueDict{})";
+                }
+                std::vector<std::string> pairs;
+                for (const auto& [key, value] : node->pairs) {
+                    pairs.push_back("{" + render_expression(key) + ", " + render_expression(value) + "}");
+                }
+                return "Value::dict({" + join(pairs, ", ") + "})";
+            }
+            default:
+                throw std::runtime_error("Unsupported expression in C++ generator");
+        }
+    }
+
+    std::string repr_string(const std::string& value) {
+        std::ostringstream oss;
+        oss << '"';
+        for (char c : value) {
+            switch (c) {
+                case '\\':
+                    oss << "\\\\";
+                    break;
+                case '"':
+                    oss << "\\\"";
+                    break;
+                case '\n':
+                    oss << "\\n";
+                    break;
+                case '\t':
+                    oss << "\\t";
+                    break;
+                case '\r':
+                    oss << "\\r";
+                    break;
+                default:
+                    oss << c;
+                    break;
+            }
+        }
+        oss << '"';
+        return oss.str();
+    }
+};
+
+// One generator temporary (`__trif_<prefix>_<n>`) is allocated per
+// ImportFrom, per re-exporting ExportNames, and — in the C++ visitor,
+// which materializes iterables (`for_allocates`) — per For, anywhere in
+// `node`'s subtree; nothing else draws from the counter. Counting them
+// statically lets the parallel path seed each declaration's visitor with
+// the prefix sum of everything before it, so the per-declaration buffers
+// concatenate to the exact bytes a sequential walk produces.
+int count_temps(const std::vector<NodePtr>& body, bool for_allocates);
+
+int count_temps(const NodePtr& node, bool for_allocates) {
+    switch (node->kind) {
+        case NodeKind::ImportFrom:
+            return 1;
+        case NodeKind::ExportNames:
+            return static_cast<const ExportNames*>(node)->source ? 1 : 0;
+        case NodeKind::FunctionDef:
+            return count_temps(static_cast<const FunctionDef*>(node)->body, for_allocates);
+        case NodeKind::If: {
+            const auto* branch = static_cast<const If*>(node);
+            return count_temps(branch->body, for_allocates) +
+                   count_temps(branch->orelse, for_allocates);
+        }
+        case NodeKind::While:
+            return count_temps(static_cast<const While*>(node)->body, for_allocates);
+        case NodeKind::For:
+            return (for_allocates ? 1 : 0) +
+                   count_temps(static_cast<const For*>(node)->body, for_allocates);
+        default:
+            return 0;
+    }
+}
+
+int count_temps(const std::vector<NodePtr>& body, bool for_allocates) {
+    int total = 0;
+    for (const auto& stmt : body) {
+        total += count_temps(stmt, for_allocates);
+    }
+    return total;
+}
+
+// Below this many top-level declarations the thread fan-out costs more
+// than the rendering it spreads out, and the generators stay sequential.
+constexpr std::size_t kParallelMinDeclarations = 32;
+
+// Shared parallel path of the three generators: render every top-level
+// statement into its own visitor and buffer on a pool of worker threads,
+// then concatenate prologue, per-declaration pieces, and epilogue in
+// source order. `make_visitor(temp_base)` builds a sink-less visitor
+// whose temporary counter starts at `temp_base` (targets that allocate
+// no temporaries ignore it); `for_allocates_temp` is set by the C++
+// generator, whose For lowering draws a temp per loop.
+template <typename Factory>
+std::string generate_parallel(const ModulePtr& module, bool for_allocates_temp,
+                              Factory make_visitor) {
+    const auto& body = module->body;
+    std::vector<int> temp_base(body.size() + 1, 0);
+    for (std::size_t i = 0; i < body.size(); ++i) {
+        temp_base[i + 1] = temp_base[i] + count_temps(body[i], for_allocates_temp);
+    }
+
+    std::vector<std::string> pieces(body.size());
+    std::atomic<std::size_t> next_index{0};
+    std::mutex failure_mutex;
+    std::exception_ptr failure;
+    std::size_t worker_count = std::thread::hardware_concurrency();
+    worker_count = std::min(std::max<std::size_t>(worker_count, 1), body.size());
+    std::vector<std::thread> workers;
+    workers.reserve(worker_count);
+    for (std::size_t i = 0; i < worker_count; ++i) {
+        workers.emplace_back([&] {
+            for (;;) {
+                std::size_t index = next_index.fetch_add(1);
+                if (index >= body.size()) {
+                    return;
+                }
+                try {
+                    auto visitor = make_visitor(temp_base[index]);
+                    visitor.enter_declarations();
+                    visitor.visit(body[index]);
+                    pieces[index] = visitor.take();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(failure_mutex);
+                    if (!failure) {
+                        failure = std::current_exception();
+                    }
+                    return;
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+
+    auto prologue = make_visitor(0);
+    prologue.emit_prologue();
+    std::string output = prologue.take();
+    for (const auto& piece : pieces) {
+        output += piece;
+    }
+    auto epilogue = make_visitor(temp_base.back());
+    epilogue.enter_declarations();
+    epilogue.emit_epilogue(module);
+    output += epilogue.take();
+    return output;
+}
+
 }  // namespace
 
 std::string PythonGenerator::generate(const ModulePtr& module) {
-    PythonVisitor visitor;
-    return visitor.generate(module);
+    if (parallel_ && module->body.size() >= kParallelMinDeclarations) {
+        return generate_parallel(module, false, [this](int temp_base) {
+            PythonVisitor visitor(shared_preamble_);
+            visitor.seed_temps(temp_base);
+            return visitor;
+        });
+    }
+    PythonVisitor visitor(shared_preamble_);
+    visitor.emit_module(module);
+    return visitor.take();
+}
+
+void PythonGenerator::generate_to(const ModulePtr& module, std::ostream& out) {
+    PythonVisitor visitor(&out, shared_preamble_);
+    visitor.emit_module(module);
+    visitor.flush();
 }
 
 std::string JavaScriptGenerator::generate(const ModulePtr& module) {
+    if (parallel_ && module->body.size() >= kParallelMinDeclarations) {
+        return generate_parallel(module, false, [](int) { return JavaScriptVisitor(); });
+    }
     JavaScriptVisitor visitor;
-    return visitor.generate(module);
+    visitor.emit_module(module);
+    return visitor.take();
+}
+
+void JavaScriptGenerator::generate_to(const ModulePtr& module, std::ostream& out) {
+    JavaScriptVisitor visitor(&out);
+    visitor.emit_module(module);
+    visitor.flush();
+}
+
+std::string CppGenerator::generate(const ModulePtr& module) {
+    if (parallel_ && module->body.size() >= kParallelMinDeclarations) {
+        return generate_parallel(module, true, [](int temp_base) {
+            CppVisitor visitor;
+            visitor.seed_temps(temp_base);
+            return visitor;
+        });
+    }
+    CppVisitor visitor;
+    visitor.emit_module(module);
+    return visitor.take();
+}
+
+void CppGenerator::generate_to(const ModulePtr& module, std::ostream& out) {
+    CppVisitor visitor(&out);
+    visitor.emit_module(module);
+    visitor.flush();
+}
+
+std::unique_ptr<Generator> create_generator(const std::string& target, bool shared_preamble,
+                                            bool parallel) {
+    if (target == "python") {
+        return std::make_unique<PythonGenerator>(shared_preamble, parallel);
+    }
+    if (target == "javascript" || target == "js") {
+        return std::make_unique<JavaScriptGenerator>(parallel);
+    }
+    if (target == "cpp" || target == "c++") {
+        return std::make_unique<CppGenerator>(parallel);
+    }
+    return nullptr;
+}
+
+std::string python_boot_module() {
+    IndentedEmitter emitter;
+    emitter.emit("# Shared bootstrap imported by every trifc-generated module in this build.");
+    emit_python_bootstrap(emitter);
+    return emitter.take();
 }
 
 }  // namespace trif::codegen
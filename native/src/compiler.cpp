@@ -1,70 +1,385 @@
 #include "trif/compiler.hpp"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
 #include <fstream>
+#include <functional>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
 
+#include "trif/astio.hpp"
 #include "trif/codegen.hpp"
 #include "trif/lexer.hpp"
+#include "trif/opt.hpp"
 #include "trif/parser.hpp"
 
 namespace trif::compiler {
 
 namespace {
 
-std::string generate_cpp_stub(const ast::ModulePtr& module) {
-    std::ostringstream oss;
-    oss << "#include <trif/runtime.hpp>\n";
-    oss << "#include <utility>\n";
-    oss << "\n";
-    oss << "int main(int argc, char** argv) {\n";
-    oss << "    trif::runtime::Runtime runtime;\n";
-    oss << "    auto exports = runtime.create_module();\n";
-    oss << "    auto default_export = runtime.null_value();\n";
-    oss << "    runtime.bootstrap(argv[0]);\n";
-    oss << "    // TODO: Generated body\n";
-    oss << "    runtime.register_module(exports, default_export);\n";
-    oss << "    return 0;\n";
-    oss << "}\n";
-    (void)module;
-    return oss.str();
+// Read-only view of a source file, memory-mapped so lexing starts without
+// copying the bytes. Falls back to a single owned read when mmap is
+// unavailable (pipes, zero-length files).
+class MappedSource {
+   public:
+    explicit MappedSource(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Unable to open file: " + path);
+        }
+        struct stat info{};
+        if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+            void* mapped = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ,
+                                  MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED) {
+                mapped_ = static_cast<const char*>(mapped);
+                size_ = static_cast<std::size_t>(info.st_size);
+                ::close(fd);
+                return;
+            }
+        }
+        ::close(fd);
+        std::ifstream stream(path, std::ios::binary);
+        if (!stream) {
+            throw std::runtime_error("Unable to open file: " + path);
+        }
+        std::ostringstream buffer;
+        buffer << stream.rdbuf();
+        fallback_ = buffer.str();
+    }
+
+    MappedSource(const MappedSource&) = delete;
+    MappedSource& operator=(const MappedSource&) = delete;
+
+    ~MappedSource() {
+        if (mapped_) {
+            ::munmap(const_cast<char*>(mapped_), size_);
+        }
+    }
+
+    std::string_view view() const {
+        return mapped_ ? std::string_view(mapped_, size_) : std::string_view(fallback_);
+    }
+
+   private:
+    const char* mapped_ = nullptr;
+    std::size_t size_ = 0;
+    std::string fallback_;
+};
+
+// FNV-1a over the source bytes and target name; cheap and stable across runs.
+std::string cache_key_target(const CompileOptions& options, const std::string& target) {
+    std::string key = target;
+    if (options.emit_ast) {
+        key += "+ast";
+    }
+    if (options.optimize) {
+        key += "+O";
+    }
+    if (options.shared_preamble) {
+        key += "+boot";
+    }
+    return key;
 }
 
-}  // namespace
+std::uint64_t content_hash(std::string_view source, const std::string& target) {
+    std::uint64_t hash = 1469598103934665603ull;
+    auto mix = [&hash](std::string_view bytes) {
+        for (char c : bytes) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+    };
+    mix(source);
+    hash *= 1099511628211ull;  // separator so (source, target) pairs cannot collide by sliding
+    mix(target);
+    return hash;
+}
 
-CompileResult Compiler::compile_source(const std::string& source, const CompileOptions& options) {
-    try {
-        auto tokens = lexer::tokenize(source);
-        auto module = parser::parse(tokens);
-        CompileResult result{module, std::nullopt};
-        if (options.target == "python") {
-            codegen::PythonGenerator generator;
-            result.output_text = generator.generate(module);
-        } else if (options.target == "javascript" || options.target == "js") {
-            codegen::JavaScriptGenerator generator;
-            result.output_text = generator.generate(module);
-        } else if (options.target == "cpp" || options.target == "c++") {
-            result.output_text = generate_cpp_stub(module);
-        } else {
+std::filesystem::path cache_entry_path(const std::string& cache_dir, std::uint64_t hash) {
+    std::ostringstream name;
+    name << std::hex << hash << ".out";
+    return std::filesystem::path(cache_dir) / name.str();
+}
+
+std::optional<std::string> read_cache_entry(const std::filesystem::path& path) {
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        return std::nullopt;
+    }
+    std::ostringstream buffer;
+    buffer << stream.rdbuf();
+    return buffer.str();
+}
+
+void write_cache_entry(const std::filesystem::path& path, const std::string& content) {
+    std::filesystem::create_directories(path.parent_path());
+    auto temp = path;
+    temp += ".tmp";
+    {
+        std::ofstream stream(temp, std::ios::binary);
+        if (!stream) {
+            return;  // cache writes are best-effort
+        }
+        stream << content;
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp, path, ec);
+}
+
+using Clock = std::chrono::steady_clock;
+
+double elapsed_ms(Clock::time_point begin) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+}
+
+void emit_output(CompileResult& result, const CompileOptions& options) {
+    const auto begin = Clock::now();
+    if (options.emit_ast) {
+        result.output_text = astio::serialize(result.module);
+    } else {
+        auto generator = codegen::create_generator(options.target, options.shared_preamble,
+                                                   options.parallel_codegen);
+        if (!generator) {
             throw std::runtime_error("Unknown target: " + options.target);
         }
-        return result;
+        result.output_text = generator->generate(result.module);
+    }
+    if (options.time_report) {
+        result.stats.codegen_ms = elapsed_ms(begin);
+        result.stats.output_bytes = result.output_text->size();
+    }
+}
+
+// The --time-report frontend: tokens are materialized up front so lexing
+// can be timed apart from parsing, which the streaming cursor interleaves.
+void run_frontend_timed(std::string_view source, const CompileOptions& options,
+                        CompileResult& result) {
+    try {
+        const auto lex_begin = Clock::now();
+        lexer::TokenStream tokens =
+            options.use_regex_lexer ? lexer::tokenize_regex(source)
+            : options.parallel_lexer
+                ? (options.aggressive_errors
+                       ? lexer::tokenize_parallel(source)
+                       : lexer::tokenize_parallel(source, result.diagnostics))
+                : (options.aggressive_errors ? lexer::tokenize(source)
+                                             : lexer::tokenize(source, result.diagnostics));
+        result.stats.lex_ms = elapsed_ms(lex_begin);
+        result.stats.tokens = tokens.size();
+        const auto parse_begin = Clock::now();
+        result.module = options.aggressive_errors
+                            ? parser::parse(source, tokens, *result.arena)
+                            : parser::parse(source, tokens, *result.arena, result.diagnostics);
+        result.stats.parse_ms = elapsed_ms(parse_begin);
+        result.stats.nodes = result.arena->allocations();
     } catch (const std::exception& exc) {
         if (options.aggressive_errors) {
             throw;
         }
-        throw std::runtime_error(std::string("Compilation failed: ") + exc.what());
+        result.diagnostics.push_back({exc.what(), 0, 0});
+    }
+}
+
+// Lexes, parses, and (with -O) optimizes; emission is left to the caller.
+CompileResult run_frontend(std::string_view source, const CompileOptions& options) {
+    CompileResult result;
+    result.arena = std::make_unique<ast::Arena>();
+    if (options.time_report) {
+        run_frontend_timed(source, options, result);
+    } else if (options.parallel_lexer) {
+        if (options.aggressive_errors) {
+            auto tokens = lexer::tokenize_parallel(source);
+            result.module = parser::parse(source, tokens, *result.arena);
+        } else {
+            try {
+                auto tokens = lexer::tokenize_parallel(source, result.diagnostics);
+                result.module = parser::parse(source, tokens, *result.arena, result.diagnostics);
+            } catch (const std::exception& exc) {
+                result.diagnostics.push_back({exc.what(), 0, 0});
+            }
+        }
+    } else if (options.aggressive_errors) {
+        if (options.use_regex_lexer) {
+            auto tokens = lexer::tokenize_regex(source);
+            result.module = parser::parse(source, tokens, *result.arena);
+        } else {
+            lexer::TokenCursor cursor(source);
+            result.module = parser::parse(source, cursor, *result.arena);
+        }
+    } else {
+        try {
+            if (options.use_regex_lexer) {
+                auto tokens = lexer::tokenize_regex(source);
+                result.module = parser::parse(source, tokens, *result.arena, result.diagnostics);
+            } else {
+                lexer::TokenCursor cursor(source, &result.diagnostics);
+                result.module = parser::parse(source, cursor, *result.arena, result.diagnostics);
+            }
+        } catch (const std::exception& exc) {
+            // The legacy regex lexer still stops at its first bad character.
+            result.diagnostics.push_back({exc.what(), 0, 0});
+        }
+    }
+    if (result.diagnostics.empty() && options.optimize) {
+        const auto opt_begin = Clock::now();
+        opt::optimize(result.module, *result.arena);
+        if (options.time_report) {
+            result.stats.optimize_ms = elapsed_ms(opt_begin);
+        }
+    }
+    return result;
+}
+
+// Fills result.outputs at each requested index from the shared module.
+// Indices beyond the first run on their own threads; the generators only
+// read the tree, so no synchronization is needed.
+void emit_target_outputs(CompileResult& result, const std::vector<std::string>& targets,
+                         const std::vector<std::size_t>& indices,
+                         const CompileOptions& options) {
+    auto emit_one = [&result, &targets, &options](std::size_t index, std::exception_ptr& failure) {
+        try {
+            auto generator = codegen::create_generator(targets[index], options.shared_preamble,
+                                                       options.parallel_codegen);
+            if (!generator) {
+                throw std::runtime_error("Unknown target: " + targets[index]);
+            }
+            result.outputs[index] = {targets[index], generator->generate(result.module)};
+        } catch (...) {
+            failure = std::current_exception();
+        }
+    };
+    std::vector<std::exception_ptr> failures(indices.size());
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < indices.size(); ++i) {
+        workers.emplace_back(emit_one, indices[i], std::ref(failures[i]));
+    }
+    emit_one(indices.front(), failures.front());
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (const auto& failure : failures) {
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+}
+
+}  // namespace
+
+CompileResult Compiler::compile_source(std::string_view source, const CompileOptions& options) {
+    std::filesystem::path cache_path;
+    if (options.cache_dir) {
+        cache_path = cache_entry_path(
+            *options.cache_dir, content_hash(source, cache_key_target(options, options.target)));
+        if (auto cached = read_cache_entry(cache_path)) {
+            return CompileResult{nullptr, nullptr, std::move(cached), {}, {}, {}};
+        }
+    }
+    CompileResult result = run_frontend(source, options);
+    if (!result.diagnostics.empty()) {
+        return result;
+    }
+    emit_output(result, options);
+    if (options.cache_dir && result.output_text) {
+        write_cache_entry(cache_path, *result.output_text);
     }
+    return result;
 }
 
 CompileResult Compiler::compile_file(const std::string& path, const CompileOptions& options) {
-    std::ifstream stream(path);
-    if (!stream) {
-        throw std::runtime_error("Unable to open file: " + path);
+    MappedSource source(path);
+    if (path.ends_with(".trifb")) {
+        // Pre-parsed module: reconstruct the AST and go straight to codegen.
+        auto arena = std::make_unique<ast::Arena>();
+        auto module = astio::deserialize(source.view(), *arena);
+        if (options.optimize) {
+            opt::optimize(module, *arena);
+        }
+        CompileResult result{std::move(arena), module, std::nullopt, {}, {}, {}};
+        emit_output(result, options);
+        return result;
     }
-    std::ostringstream buffer;
-    buffer << stream.rdbuf();
-    return compile_source(buffer.str(), options);
+    return compile_source(source.view(), options);
+}
+
+CompileResult Compiler::compile_source(std::string_view source,
+                                       const std::vector<std::string>& targets,
+                                       const CompileOptions& options) {
+    if (targets.empty()) {
+        throw std::runtime_error("No targets requested");
+    }
+    CompileResult result;
+    result.outputs.resize(targets.size());
+    std::vector<std::filesystem::path> cache_paths(targets.size());
+    std::vector<std::size_t> pending;
+    for (std::size_t i = 0; i < targets.size(); ++i) {
+        if (options.cache_dir) {
+            cache_paths[i] = cache_entry_path(
+                *options.cache_dir, content_hash(source, cache_key_target(options, targets[i])));
+            if (auto cached = read_cache_entry(cache_paths[i])) {
+                result.outputs[i] = {targets[i], std::move(*cached)};
+                continue;
+            }
+        }
+        pending.push_back(i);
+    }
+    if (pending.empty()) {
+        return result;  // every target was cached; nothing to parse
+    }
+    CompileResult compiled = run_frontend(source, options);
+    compiled.outputs = std::move(result.outputs);
+    if (!compiled.diagnostics.empty()) {
+        compiled.outputs.clear();
+        return compiled;
+    }
+    const auto emit_begin = Clock::now();
+    emit_target_outputs(compiled, targets, pending, options);
+    if (options.time_report) {
+        compiled.stats.codegen_ms = elapsed_ms(emit_begin);
+        for (const auto& output : compiled.outputs) {
+            compiled.stats.output_bytes += output.text.size();
+        }
+    }
+    if (options.cache_dir) {
+        for (std::size_t index : pending) {
+            write_cache_entry(cache_paths[index], compiled.outputs[index].text);
+        }
+    }
+    return compiled;
+}
+
+CompileResult Compiler::compile_file(const std::string& path,
+                                     const std::vector<std::string>& targets,
+                                     const CompileOptions& options) {
+    MappedSource source(path);
+    if (path.ends_with(".trifb")) {
+        if (targets.empty()) {
+            throw std::runtime_error("No targets requested");
+        }
+        CompileResult result;
+        result.arena = std::make_unique<ast::Arena>();
+        result.module = astio::deserialize(source.view(), *result.arena);
+        if (options.optimize) {
+            opt::optimize(result.module, *result.arena);
+        }
+        result.outputs.resize(targets.size());
+        std::vector<std::size_t> indices(targets.size());
+        for (std::size_t i = 0; i < indices.size(); ++i) {
+            indices[i] = i;
+        }
+        emit_target_outputs(result, targets, indices, options);
+        return result;
+    }
+    return compile_source(source.view(), targets, options);
 }
 
 }  // namespace trif::compiler
@@ -0,0 +1,166 @@
+#include "trif/daemon.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace trif::daemon {
+
+namespace {
+
+bool read_exact(int fd, char* buffer, std::size_t count) {
+    std::size_t total = 0;
+    while (total < count) {
+        ssize_t got = ::read(fd, buffer + total, count - total);
+        if (got <= 0) {
+            return false;
+        }
+        total += static_cast<std::size_t>(got);
+    }
+    return true;
+}
+
+bool write_all(int fd, const char* buffer, std::size_t count) {
+    std::size_t total = 0;
+    while (total < count) {
+        ssize_t wrote = ::write(fd, buffer + total, count - total);
+        if (wrote <= 0) {
+            return false;
+        }
+        total += static_cast<std::size_t>(wrote);
+    }
+    return true;
+}
+
+bool read_line(int fd, std::string& line) {
+    line.clear();
+    char c;
+    while (true) {
+        ssize_t got = ::read(fd, &c, 1);
+        if (got <= 0) {
+            return false;
+        }
+        if (c == '\n') {
+            return true;
+        }
+        line.push_back(c);
+    }
+}
+
+void send_response(int fd, const char* status, const std::string& payload) {
+    std::ostringstream header;
+    header << status << ' ' << payload.size() << '\n';
+    std::string header_text = header.str();
+    if (write_all(fd, header_text.data(), header_text.size())) {
+        write_all(fd, payload.data(), payload.size());
+    }
+}
+
+// Handles requests on one connection until the peer disconnects or asks for
+// shutdown. Returns false when the server should stop accepting.
+bool handle_connection(int fd, compiler::Compiler& compiler,
+                       const compiler::CompileOptions& base_options) {
+    std::string header;
+    std::string source;
+    while (read_line(fd, header)) {
+        if (header == "shutdown") {
+            send_response(fd, "ok", "");
+            return false;
+        }
+        std::istringstream fields(header);
+        std::string verb;
+        std::string target;
+        std::size_t byte_count = 0;
+        fields >> verb >> target >> byte_count;
+        if (verb != "compile" || fields.fail()) {
+            send_response(fd, "error", "Malformed request: " + header);
+            continue;
+        }
+        source.resize(byte_count);
+        if (byte_count > 0 && !read_exact(fd, source.data(), byte_count)) {
+            return true;
+        }
+        try {
+            auto options = base_options;
+            options.target = target;
+            auto result = compiler.compile_source(source, options);
+            if (!result.diagnostics.empty()) {
+                std::string combined;
+                for (const auto& diagnostic : result.diagnostics) {
+                    if (!combined.empty()) {
+                        combined.push_back('\n');
+                    }
+                    combined += diagnostics::render(diagnostic);
+                }
+                send_response(fd, "error", combined);
+                continue;
+            }
+            send_response(fd, "ok", result.output_text.value_or(""));
+        } catch (const std::exception& exc) {
+            send_response(fd, "error", exc.what());
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int serve(const std::string& socket_path, const compiler::CompileOptions& base_options) {
+    ::signal(SIGPIPE, SIG_IGN);
+    int server_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server_fd < 0) {
+        throw std::runtime_error("Unable to create daemon socket");
+    }
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        ::close(server_fd);
+        throw std::runtime_error("Socket path too long: " + socket_path);
+    }
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+    ::unlink(socket_path.c_str());
+    if (::bind(server_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        ::listen(server_fd, 8) < 0) {
+        ::close(server_fd);
+        throw std::runtime_error("Unable to bind daemon socket: " + socket_path);
+    }
+    std::cerr << "trifc: daemon listening on " << socket_path << std::endl;
+    std::atomic<bool> running{true};
+    // Joined before serve returns, so the handlers' references to `running`
+    // and `base_options` never outlive this frame.
+    std::vector<std::thread> connections;
+    while (running) {
+        int client_fd = ::accept(server_fd, nullptr, nullptr);
+        if (client_fd < 0) {
+            break;
+        }
+        // One thread per connection so an idle editor session cannot block
+        // other clients; Compiler is stateless, so each gets its own.
+        connections.emplace_back([client_fd, server_fd, &running, &base_options] {
+            compiler::Compiler compiler;
+            if (!handle_connection(client_fd, compiler, base_options)) {
+                running = false;
+                ::shutdown(server_fd, SHUT_RDWR);
+            }
+            ::close(client_fd);
+        });
+    }
+    for (auto& connection : connections) {
+        connection.join();
+    }
+    ::close(server_fd);
+    ::unlink(socket_path.c_str());
+    return 0;
+}
+
+}  // namespace trif::daemon
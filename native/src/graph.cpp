@@ -0,0 +1,342 @@
+#include "trif/graph.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "trif/ast.hpp"
+#include "trif/codegen.hpp"
+#include "trif/diagnostics.hpp"
+#include "trif/lexer.hpp"
+#include "trif/opt.hpp"
+#include "trif/parser.hpp"
+
+namespace trif::graph {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// One module in the import graph. The arena is retained until output so
+// dependency edges can be re-walked without re-parsing.
+struct ModuleRecord {
+    std::string display;           // path as shown in messages
+    fs::path path;                 // canonical source path
+    fs::path package_root;         // search root for this module's own imports
+    std::unique_ptr<ast::Arena> arena;
+    ast::ModulePtr module = nullptr;
+    std::string output;
+    std::vector<std::size_t> deps;
+    diagnostics::DiagnosticList diagnostics;
+};
+
+std::optional<std::string> read_file(const fs::path& path) {
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        return std::nullopt;
+    }
+    std::ostringstream buffer;
+    buffer << stream.rdbuf();
+    return buffer.str();
+}
+
+// Pulls the "entry" value out of a trif.json manifest. The manifests the
+// package manager writes are flat, so a targeted scan beats a JSON parser.
+std::optional<std::string> manifest_entry(const std::string& manifest) {
+    std::size_t key = manifest.find("\"entry\"");
+    if (key == std::string::npos) {
+        return std::nullopt;
+    }
+    std::size_t colon = manifest.find(':', key);
+    if (colon == std::string::npos) {
+        return std::nullopt;
+    }
+    std::size_t open = manifest.find('"', colon);
+    if (open == std::string::npos) {
+        return std::nullopt;
+    }
+    std::size_t close = manifest.find('"', open + 1);
+    if (close == std::string::npos) {
+        return std::nullopt;
+    }
+    return manifest.substr(open + 1, close - open - 1);
+}
+
+fs::path dotted_to_path(const std::string& name) {
+    fs::path path;
+    std::size_t start = 0;
+    for (;;) {
+        std::size_t dot = name.find('.', start);
+        path /= name.substr(start, dot - start);
+        if (dot == std::string::npos) {
+            break;
+        }
+        start = dot + 1;
+    }
+    return path;
+}
+
+// Resolves a dotted import name against the runtime's search order: the
+// importer's package root, the entry root, then entry_root/trif_pkg, first
+// as a plain <parts>.trif file and then as an installed package whose
+// trif.json names the entry file. std.* modules are builtin.
+std::optional<fs::path> resolve_import(const std::string& name, const fs::path& importer_root,
+                                       const fs::path& entry_root, fs::path& package_root_out) {
+    std::vector<fs::path> roots = {importer_root, entry_root, entry_root / "trif_pkg"};
+    fs::path relative = dotted_to_path(name);
+    for (const auto& root : roots) {
+        if (root.empty()) {
+            continue;
+        }
+        fs::path file = root / relative;
+        file += ".trif";
+        std::error_code ec;
+        if (fs::exists(file, ec)) {
+            package_root_out = root;
+            return fs::weakly_canonical(file, ec);
+        }
+        fs::path package_dir = root / relative;
+        fs::path manifest_path = package_dir / "trif.json";
+        if (fs::exists(manifest_path, ec)) {
+            auto manifest = read_file(manifest_path);
+            if (!manifest) {
+                continue;
+            }
+            auto entry = manifest_entry(*manifest);
+            fs::path entry_file = package_dir / (entry ? *entry : "index.trif");
+            if (fs::exists(entry_file, ec)) {
+                package_root_out = package_dir;
+                return fs::weakly_canonical(entry_file, ec);
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+// Import names referenced by the module's top-level statements.
+std::vector<std::string> collect_imports(const ast::ModulePtr& module) {
+    std::vector<std::string> names;
+    for (const auto& stmt : module->body) {
+        if (stmt->kind == ast::NodeKind::Import) {
+            names.push_back(static_cast<ast::Import*>(stmt)->module);
+        } else if (stmt->kind == ast::NodeKind::ImportFrom) {
+            names.push_back(static_cast<ast::ImportFrom*>(stmt)->module);
+        } else if (stmt->kind == ast::NodeKind::ExportNames) {
+            auto* exports = static_cast<ast::ExportNames*>(stmt);
+            if (exports->source) {
+                names.push_back(*exports->source);
+            }
+        }
+    }
+    return names;
+}
+
+// Shared state for the discovery/compile pool. Records are appended under
+// the mutex; workers own a record exclusively while processing it.
+struct Build {
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<std::size_t> queue;
+    std::vector<std::unique_ptr<ModuleRecord>> records;
+    std::unordered_map<std::string, std::size_t> by_path;
+    fs::path entry_root;
+    std::size_t active = 0;
+    bool failed = false;
+};
+
+// Registers `path` if unseen and enqueues it for a worker. Caller holds the
+// build mutex.
+std::size_t enqueue_locked(Build& build, const fs::path& path, const fs::path& package_root) {
+    auto key = path.string();
+    if (auto it = build.by_path.find(key); it != build.by_path.end()) {
+        return it->second;
+    }
+    auto record = std::make_unique<ModuleRecord>();
+    record->display = key;
+    record->path = path;
+    record->package_root = package_root;
+    build.records.push_back(std::move(record));
+    std::size_t index = build.records.size() - 1;
+    build.by_path.emplace(std::move(key), index);
+    build.queue.push_back(index);
+    build.ready.notify_one();
+    return index;
+}
+
+void worker_loop(Build& build, const compiler::CompileOptions& options) {
+    for (;;) {
+        ModuleRecord* record_ptr = nullptr;
+        {
+            std::unique_lock lock(build.mutex);
+            build.ready.wait(lock, [&] { return !build.queue.empty() || build.active == 0; });
+            if (build.queue.empty()) {
+                return;  // no work left and nobody can create more
+            }
+            std::size_t index = build.queue.front();
+            build.queue.pop_front();
+            ++build.active;
+            record_ptr = build.records[index].get();  // stable; the vector is not
+        }
+        ModuleRecord& record = *record_ptr;
+        auto source = read_file(record.path);
+        if (!source) {
+            record.diagnostics.push_back({"Unable to open file: " + record.display, 0, 0});
+        } else {
+            record.arena = std::make_unique<ast::Arena>();
+            lexer::TokenCursor cursor(*source, &record.diagnostics);
+            record.module = parser::parse(*source, cursor, *record.arena, record.diagnostics);
+        }
+        if (record.diagnostics.empty()) {
+            for (const auto& name : collect_imports(record.module)) {
+                if (name.rfind("std.", 0) == 0 || name == "std") {
+                    continue;  // builtin runtime module
+                }
+                fs::path package_root;
+                auto resolved =
+                    resolve_import(name, record.package_root, build.entry_root, package_root);
+                if (!resolved) {
+                    record.diagnostics.push_back({"Unresolved import '" + name + "'", 0, 0});
+                    continue;
+                }
+                std::unique_lock lock(build.mutex);
+                record.deps.push_back(enqueue_locked(build, *resolved, package_root));
+            }
+        }
+        if (record.diagnostics.empty()) {
+            try {
+                if (options.optimize) {
+                    opt::optimize(record.module, *record.arena);
+                }
+                auto generator = codegen::create_generator(options.target);
+                if (!generator) {
+                    throw std::runtime_error("Unknown target: " + options.target);
+                }
+                record.output = generator->generate(record.module);
+            } catch (const std::exception& exc) {
+                record.diagnostics.push_back({exc.what(), 0, 0});
+            }
+        }
+        {
+            std::unique_lock lock(build.mutex);
+            if (!record.diagnostics.empty()) {
+                build.failed = true;
+            }
+            --build.active;
+            if (build.active == 0 && build.queue.empty()) {
+                build.ready.notify_all();
+            }
+        }
+    }
+}
+
+std::string output_extension(const std::string& target) {
+    if (target == "javascript" || target == "js") {
+        return ".js";
+    }
+    if (target == "cpp" || target == "c++") {
+        return ".cpp";
+    }
+    return ".py";
+}
+
+fs::path output_path_for(const ModuleRecord& record, const Build& build,
+                         const std::optional<std::string>& output_dir,
+                         const std::string& target) {
+    std::string extension = output_extension(target);
+    if (!output_dir) {
+        fs::path mapped = record.path;
+        mapped.replace_extension(extension);
+        return mapped;
+    }
+    std::error_code ec;
+    fs::path relative = fs::relative(record.path, build.entry_root, ec);
+    if (ec || relative.empty() || *relative.begin() == "..") {
+        relative = record.path.filename();
+    }
+    relative.replace_extension(extension);
+    return fs::path(*output_dir) / relative;
+}
+
+// Postorder walk so dependencies are written before their importers.
+bool emit_in_order(std::size_t index, Build& build, std::vector<int>& state,
+                   const std::optional<std::string>& output_dir, const std::string& target) {
+    if (state[index] == 2) {
+        return true;
+    }
+    if (state[index] == 1) {
+        std::cerr << "trifc: Import cycle involving " << build.records[index]->display
+                  << std::endl;
+        return false;
+    }
+    state[index] = 1;
+    for (std::size_t dep : build.records[index]->deps) {
+        if (!emit_in_order(dep, build, state, output_dir, target)) {
+            return false;
+        }
+    }
+    state[index] = 2;
+    const ModuleRecord& record = *build.records[index];
+    fs::path destination = output_path_for(record, build, output_dir, target);
+    std::error_code ec;
+    fs::create_directories(destination.parent_path(), ec);
+    std::ofstream stream(destination);
+    if (!stream) {
+        std::cerr << "trifc: Unable to write to output path: " << destination.string()
+                  << std::endl;
+        return false;
+    }
+    stream << record.output;
+    return true;
+}
+
+}  // namespace
+
+int compile_graph(const std::string& entry, const compiler::CompileOptions& options,
+                  const std::optional<std::string>& output_dir, unsigned jobs) {
+    Build build;
+    std::error_code ec;
+    fs::path entry_path = fs::weakly_canonical(entry, ec);
+    if (ec || !fs::exists(entry_path)) {
+        std::cerr << "trifc: Unable to open file: " << entry << std::endl;
+        return 1;
+    }
+    build.entry_root = entry_path.parent_path();
+    {
+        std::unique_lock lock(build.mutex);
+        enqueue_locked(build, entry_path, build.entry_root);
+    }
+    unsigned worker_count = jobs ? jobs : std::thread::hardware_concurrency();
+    worker_count = std::max(1u, worker_count);
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < worker_count; ++i) {
+        workers.emplace_back(worker_loop, std::ref(build), std::cref(options));
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    if (build.failed) {
+        for (const auto& record : build.records) {
+            for (const auto& diagnostic : record->diagnostics) {
+                std::cerr << "trifc: " << record->display << ": "
+                          << diagnostics::render(diagnostic) << std::endl;
+            }
+        }
+        return 1;
+    }
+    std::vector<int> state(build.records.size(), 0);
+    if (!emit_in_order(0, build, state, output_dir, options.target)) {
+        return 1;
+    }
+    return 0;
+}
+
+}  // namespace trif::graph
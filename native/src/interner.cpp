@@ -0,0 +1,54 @@
+#include "trif/interner.hpp"
+
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace trif::intern {
+
+namespace {
+
+// One process-wide table. A deque keeps spellings at stable addresses while
+// the table grows, so `spelling` can hand out references without copying.
+// Machine-generated modules repeat a few hundred identifiers tens of
+// thousands of times, so the read path (already-seen name) dominates and
+// takes only the shared lock.
+struct Table {
+    std::shared_mutex mutex;
+    std::deque<std::string> spellings{std::string()};  // slot 0 = ""
+    std::unordered_map<std::string_view, std::uint32_t> by_text{{std::string_view(), 0}};
+};
+
+Table& table() {
+    static Table instance;
+    return instance;
+}
+
+}  // namespace
+
+Symbol intern(std::string_view text) {
+    Table& t = table();
+    {
+        std::shared_lock lock(t.mutex);
+        if (auto it = t.by_text.find(text); it != t.by_text.end()) {
+            return Symbol(it->second);
+        }
+    }
+    std::unique_lock lock(t.mutex);
+    if (auto it = t.by_text.find(text); it != t.by_text.end()) {
+        return Symbol(it->second);  // another thread won the race
+    }
+    auto index = static_cast<std::uint32_t>(t.spellings.size());
+    const std::string& stored = t.spellings.emplace_back(text);
+    t.by_text.emplace(stored, index);
+    return Symbol(index);
+}
+
+const std::string& spelling(Symbol symbol) {
+    Table& t = table();
+    std::shared_lock lock(t.mutex);
+    return t.spellings[symbol.index_];
+}
+
+}  // namespace trif::intern
@@ -1,65 +1,616 @@
 #include "trif/lexer.hpp"
 
+#include "trif/source.hpp"
+
 #include <algorithm>
 #include <cctype>
+#include <memory>
+#include <optional>
 #include <regex>
 #include <stdexcept>
 #include <string_view>
-#include <unordered_map>
-#include <unordered_set>
+#include <thread>
+#include <vector>
+#include <array>
 
 namespace trif::lexer {
 
 namespace {
 
+// Keyword classification runs once per identifier token, so the table is a
+// compile-time perfect hash rather than a runtime set: first character, last
+// character, and length spread the 19 keywords over 64 slots with no
+// collisions (the constexpr builder fails the build if an edit introduces
+// one). Lookup is one slot index plus one string compare, no allocation.
+struct KeywordEntry {
+    std::string_view text;
+    TokenKind kind = TokenKind::Name;
+};
+
+constexpr std::size_t kKeywordSlots = 64;
+
+constexpr std::size_t keyword_slot(std::string_view word) {
+    return (static_cast<std::size_t>(static_cast<unsigned char>(word.front())) +
+            2 * static_cast<std::size_t>(static_cast<unsigned char>(word.back())) +
+            8 * word.size()) %
+           kKeywordSlots;
+}
+
+constexpr auto kKeywords = [] {
+    std::array<KeywordEntry, kKeywordSlots> table{};
+    constexpr KeywordEntry entries[] = {
+        {"let", TokenKind::Let},         {"fn", TokenKind::Fn},
+        {"function", TokenKind::Function}, {"return", TokenKind::Return},
+        {"if", TokenKind::If},           {"else", TokenKind::Else},
+        {"while", TokenKind::While},     {"for", TokenKind::For},
+        {"in", TokenKind::In},           {"true", TokenKind::True},
+        {"false", TokenKind::False},     {"null", TokenKind::Null},
+        {"import", TokenKind::Import},   {"as", TokenKind::As},
+        {"from", TokenKind::From},       {"const", TokenKind::Const},
+        {"export", TokenKind::Export},   {"default", TokenKind::Default},
+        {"spawn", TokenKind::Spawn},
+    };
+    for (const auto& entry : entries) {
+        if (!table[keyword_slot(entry.text)].text.empty()) {
+            throw "keyword_slot collision; pick new multipliers";
+        }
+        table[keyword_slot(entry.text)] = entry;
+    }
+    return table;
+}();
+
+// Two-character operators; single-character ones are dispatched straight from
+// the scanner's switch.
+constexpr std::string_view kPairOps[] = {"==", "!=", "<=", ">=", "=>", "&&", "||"};
+
+constexpr bool is_pair_op(char first, char second) {
+    for (std::string_view op : kPairOps) {
+        if (op[0] == first && op[1] == second) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool is_name_start(unsigned char c) {
+    return c == '_' || std::isalpha(c);
+}
+
+bool is_name_continue(unsigned char c) {
+    return c == '_' || std::isalnum(c);
+}
+
+bool is_digit(unsigned char c) {
+    return c >= '0' && c <= '9';
+}
+
+// --- Regex fallback path -----------------------------------------------------
+//
+// Retained behind CompileOptions::use_regex_lexer (trifc --legacy-lexer) so the
+// DFA scanner below can be validated token-for-token against it on real
+// corpora before the table is deleted.
+
 struct Pattern {
-    std::string name;
+    TokenKind kind;
+    bool skip;
     std::regex regex;
 };
 
 const std::vector<Pattern>& token_patterns() {
     static const std::vector<Pattern> patterns = {
-        {"NUMBER", std::regex(R"(\d+(?:\.\d+)?)", std::regex::ECMAScript)},
-        {"STRING", std::regex(R"(("([^"\\]|\\.)*")|('([^'\\]|\\.)*'))", std::regex::ECMAScript)},
-        {"COMMENT", std::regex(R"(//[^\n]*)", std::regex::ECMAScript)},
-        {"NAME", std::regex(R"([A-Za-z_][A-Za-z0-9_]*)", std::regex::ECMAScript)},
-        {"OP", std::regex(R"(==|!=|<=|>=|=>|&&|\|\||[+\-*/%=<>!])", std::regex::ECMAScript)},
-        {"NEWLINE", std::regex(R"(\n)", std::regex::ECMAScript)},
-        {"SKIP", std::regex(R"([ \t]+)", std::regex::ECMAScript)},
-        {"LPAREN", std::regex(R"(\()", std::regex::ECMAScript)},
-        {"RPAREN", std::regex(R"(\))", std::regex::ECMAScript)},
-        {"LBRACE", std::regex(R"(\{)", std::regex::ECMAScript)},
-        {"RBRACE", std::regex(R"(\})", std::regex::ECMAScript)},
-        {"LBRACKET", std::regex(R"(\[)", std::regex::ECMAScript)},
-        {"RBRACKET", std::regex(R"(\])", std::regex::ECMAScript)},
-        {"COMMA", std::regex(R"(,)", std::regex::ECMAScript)},
-        {"COLON", std::regex(R"(:)", std::regex::ECMAScript)},
-        {"DOT", std::regex(R"(\.)", std::regex::ECMAScript)},
-        {"SEMICOLON", std::regex(R"(;)", std::regex::ECMAScript)},
+        {TokenKind::Number, false, std::regex(R"(\d+(?:\.\d+)?)", std::regex::ECMAScript)},
+        {TokenKind::String, false,
+         std::regex(R"(("([^"\\]|\\.)*")|('([^'\\]|\\.)*'))", std::regex::ECMAScript)},
+        {TokenKind::Eof, true, std::regex(R"(//[^\n]*)", std::regex::ECMAScript)},  // COMMENT
+        {TokenKind::Name, false, std::regex(R"([A-Za-z_][A-Za-z0-9_]*)", std::regex::ECMAScript)},
+        {TokenKind::Op, false, std::regex(R"(==|!=|<=|>=|=>|&&|\|\||[+\-*/%=<>!])", std::regex::ECMAScript)},
+        {TokenKind::Newline, false, std::regex(R"(\n)", std::regex::ECMAScript)},
+        {TokenKind::Eof, true, std::regex(R"([ \t]+)", std::regex::ECMAScript)},  // SKIP
+        {TokenKind::Lparen, false, std::regex(R"(\()", std::regex::ECMAScript)},
+        {TokenKind::Rparen, false, std::regex(R"(\))", std::regex::ECMAScript)},
+        {TokenKind::Lbrace, false, std::regex(R"(\{)", std::regex::ECMAScript)},
+        {TokenKind::Rbrace, false, std::regex(R"(\})", std::regex::ECMAScript)},
+        {TokenKind::Lbracket, false, std::regex(R"(\[)", std::regex::ECMAScript)},
+        {TokenKind::Rbracket, false, std::regex(R"(\])", std::regex::ECMAScript)},
+        {TokenKind::Comma, false, std::regex(R"(,)", std::regex::ECMAScript)},
+        {TokenKind::Colon, false, std::regex(R"(:)", std::regex::ECMAScript)},
+        {TokenKind::Dot, false, std::regex(R"(\.)", std::regex::ECMAScript)},
+        {TokenKind::Semicolon, false, std::regex(R"(;)", std::regex::ECMAScript)},
     };
     return patterns;
 }
 
-const std::unordered_set<std::string> kKeywords = {
-    "let",      "fn",      "function", "return",  "if",     "else",    "while",
-    "for",      "in",      "true",     "false",   "null",   "import",  "as",
-    "from",     "const",   "export",   "default", "spawn",
+// Incremental DFA scanner: one token per next() call, an Eof token forever
+// once the source is exhausted. With a diagnostics sink, malformed input is
+// recorded and skipped; without one, the first problem throws as before.
+// Tokens carry only their byte offset; the inner loop does no line/column
+// arithmetic, and positions for diagnostics come from a SourceManager whose
+// newline index is built on the first error.
+class Scanner {
+   public:
+    Scanner(std::string_view source, diagnostics::DiagnosticList* diagnostics)
+        : data_(source.data()), size_(source.size()), sources_(source),
+          diagnostics_(diagnostics) {}
+
+    Token next() {
+        while (index_ < size_) {
+            const char c = data_[index_];
+            switch (c) {
+                case ' ':
+                case '\t': {
+                    std::size_t end = index_ + 1;
+                    while (end < size_ && (data_[end] == ' ' || data_[end] == '\t')) {
+                        ++end;
+                    }
+                    index_ = end;
+                    continue;
+                }
+                case '\n': {
+                    Token token{TokenKind::Newline, lexeme(index_, 1), index_};
+                    ++index_;
+                    return token;
+                }
+                case '/': {
+                    if (index_ + 1 < size_ && data_[index_ + 1] == '/') {
+                        std::size_t end = index_ + 2;
+                        while (end < size_ && data_[end] != '\n') {
+                            ++end;
+                        }
+                        index_ = end;
+                        continue;
+                    }
+                    if (index_ + 1 < size_ && data_[index_ + 1] == '*') {
+                        std::string_view remaining(data_ + index_, size_ - index_);
+                        std::size_t end = remaining.find("*/");
+                        if (end == std::string_view::npos) {
+                            report("Unterminated block comment", index_, /*with_column=*/false);
+                            index_ = size_;  // the comment swallows the rest of the file
+                            continue;
+                        }
+                        index_ += end + 2;
+                        continue;
+                    }
+                    return single(TokenKind::Op);
+                }
+                case '"':
+                case '\'': {
+                    const char quote = c;
+                    std::size_t end = index_ + 1;
+                    while (end < size_ && data_[end] != quote) {
+                        if (data_[end] == '\\' && end + 1 < size_) {
+                            end += 2;
+                        } else if (data_[end] == '\n') {
+                            break;
+                        } else {
+                            ++end;
+                        }
+                    }
+                    if (end >= size_ || data_[end] != quote) {
+                        report("Unterminated string literal", index_);
+                        index_ = end;  // resume at the newline
+                        continue;
+                    }
+                    std::size_t raw_length = end + 1 - index_;
+                    Token token{TokenKind::String, lexeme(index_, raw_length), index_};
+                    index_ = end + 1;
+                    return token;
+                }
+                case '(':
+                    return single(TokenKind::Lparen);
+                case ')':
+                    return single(TokenKind::Rparen);
+                case '{':
+                    return single(TokenKind::Lbrace);
+                case '}':
+                    return single(TokenKind::Rbrace);
+                case '[':
+                    return single(TokenKind::Lbracket);
+                case ']':
+                    return single(TokenKind::Rbracket);
+                case ',':
+                    return single(TokenKind::Comma);
+                case ':':
+                    return single(TokenKind::Colon);
+                case '.':
+                    return single(TokenKind::Dot);
+                case ';':
+                    return single(TokenKind::Semicolon);
+                case '=':
+                case '!':
+                case '<':
+                case '>': {
+                    if (index_ + 1 < size_ && is_pair_op(c, data_[index_ + 1])) {
+                        return pair_op();
+                    }
+                    return single(TokenKind::Op);
+                }
+                case '&':
+                case '|': {
+                    if (index_ + 1 < size_ && is_pair_op(c, data_[index_ + 1])) {
+                        return pair_op();
+                    }
+                    report("Unexpected character '" + std::string(1, c) + "'", index_);
+                    ++index_;
+                    continue;
+                }
+                case '+':
+                case '-':
+                case '*':
+                case '%':
+                    return single(TokenKind::Op);
+                default: {
+                    if (is_digit(static_cast<unsigned char>(c))) {
+                        std::size_t end = index_ + 1;
+                        while (end < size_ && is_digit(static_cast<unsigned char>(data_[end]))) {
+                            ++end;
+                        }
+                        if (end + 1 < size_ && data_[end] == '.' &&
+                            is_digit(static_cast<unsigned char>(data_[end + 1]))) {
+                            end += 2;
+                            while (end < size_ && is_digit(static_cast<unsigned char>(data_[end]))) {
+                                ++end;
+                            }
+                        }
+                        Token token{TokenKind::Number, lexeme(index_, end - index_), index_};
+                        index_ = end;
+                        return token;
+                    }
+                    if (is_name_start(static_cast<unsigned char>(c))) {
+                        std::size_t end = index_ + 1;
+                        while (end < size_ && is_name_continue(static_cast<unsigned char>(data_[end]))) {
+                            ++end;
+                        }
+                        std::string_view value = lexeme(index_, end - index_);
+                        Token token{keyword_kind(value), value, index_};
+                        index_ = end;
+                        return token;
+                    }
+                    report("Unexpected character '" + std::string(1, c) + "'", index_);
+                    ++index_;
+                    continue;
+                }
+            }
+        }
+        return {TokenKind::Eof, {}, size_};
+    }
+
+   private:
+    std::string_view lexeme(std::size_t start, std::size_t length) const {
+        return std::string_view(data_ + start, length);
+    }
+
+    Token single(TokenKind kind) {
+        Token token{kind, lexeme(index_, 1), index_};
+        ++index_;
+        return token;
+    }
+
+    Token pair_op() {
+        Token token{TokenKind::Op, lexeme(index_, 2), index_};
+        index_ += 2;
+        return token;
+    }
+
+    void report(std::string message, std::size_t offset, bool with_column = true) {
+        source::LineColumn at = sources_.position(offset);
+        if (!with_column) {
+            at.column = 0;  // line-only wording, e.g. unterminated block comments
+        }
+        if (!diagnostics_) {
+            throw std::runtime_error(diagnostics::render({std::move(message), at.line, at.column}));
+        }
+        diagnostics_->push_back({std::move(message), at.line, at.column});
+    }
+
+    const char* data_;
+    std::size_t size_;
+    std::size_t index_ = 0;
+    source::SourceManager sources_;
+    diagnostics::DiagnosticList* diagnostics_;
+};
+
+TokenStream run_scanner(std::string_view source, diagnostics::DiagnosticList* diagnostics) {
+    Scanner scanner(source, diagnostics);
+    TokenStream tokens;
+    for (;;) {
+        tokens.push_back(scanner.next());
+        if (tokens.back().kind == TokenKind::Eof) {
+            break;
+        }
+    }
+    return tokens;
+}
+
+// One chunk of a parallel lex: the byte offset it starts at (always the
+// start of a line) and the 1-based line number there.
+struct ChunkPlan {
+    std::size_t begin;
+    int line;
 };
 
-std::string uppercase(const std::string& value) {
-    std::string result;
-    result.reserve(value.size());
-    for (char c : value) {
-        result.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+// Walks the source once with a reduced state machine — just enough to know
+// whether a newline sits inside a string or block comment — and records a
+// chunk boundary at the first safe newline past each `chunk_target` bytes.
+// A scanner started cold at a boundary produces exactly the tokens the
+// sequential scanner would from that point. Line counting matches
+// source::SourceManager, which the chunk scanners' diagnostics are fixed up
+// against: every '\n' byte counts, including inside block comments and
+// backslash escapes in strings.
+std::vector<ChunkPlan> plan_chunks(std::string_view source, std::size_t chunk_target) {
+    enum class State { Normal, LineComment, BlockComment, String };
+    std::vector<ChunkPlan> plan{{0, 1}};
+    State state = State::Normal;
+    char quote = 0;
+    int line = 1;
+    std::size_t next_target = chunk_target;
+    for (std::size_t i = 0; i < source.size(); ++i) {
+        char c = source[i];
+        switch (state) {
+            case State::Normal:
+                if (c == '"' || c == '\'') {
+                    state = State::String;
+                    quote = c;
+                    continue;
+                }
+                if (c == '/' && i + 1 < source.size()) {
+                    if (source[i + 1] == '/') {
+                        state = State::LineComment;
+                        ++i;
+                        continue;
+                    }
+                    if (source[i + 1] == '*') {
+                        state = State::BlockComment;
+                        ++i;
+                        continue;
+                    }
+                }
+                break;
+            case State::String:
+                if (c == '\\' && i + 1 < source.size()) {
+                    // The skipped escape may itself be a newline, and
+                    // SourceManager counts every '\n' byte.
+                    if (source[i + 1] == '\n') {
+                        ++line;
+                    }
+                    ++i;
+                    continue;
+                }
+                if (c == quote) {
+                    state = State::Normal;
+                    continue;
+                }
+                if (c == '\n') {
+                    state = State::Normal;  // unterminated; the scanner stops here too
+                }
+                break;
+            case State::LineComment:
+                if (c == '\n') {
+                    state = State::Normal;
+                }
+                break;
+            case State::BlockComment:
+                if (c == '\n') {
+                    ++line;
+                } else if (c == '*' && i + 1 < source.size() && source[i + 1] == '/') {
+                    state = State::Normal;
+                    ++i;
+                }
+                continue;
+        }
+        if (c == '\n') {
+            ++line;
+            if (i + 1 >= next_target && i + 1 < source.size()) {
+                plan.push_back({i + 1, line});
+                next_target = i + 1 + chunk_target;
+            }
+        }
     }
-    return result;
+    return plan;
 }
 
-std::string decode_string_literal(const std::string& raw) {
+TokenStream run_parallel(std::string_view source, diagnostics::DiagnosticList* diagnostics,
+                         unsigned jobs) {
+    constexpr std::size_t kMinChunkBytes = 64 * 1024;
+    unsigned worker_count = jobs ? jobs : std::thread::hardware_concurrency();
+    std::size_t max_chunks = std::max<std::size_t>(source.size() / kMinChunkBytes, 1);
+    worker_count = static_cast<unsigned>(
+        std::min<std::size_t>(std::max(worker_count, 1u), max_chunks));
+    std::vector<ChunkPlan> plan;
+    if (worker_count > 1) {
+        plan = plan_chunks(source, source.size() / worker_count);
+    }
+    if (plan.size() <= 1) {
+        return run_scanner(source, diagnostics);  // too small to be worth splitting
+    }
+
+    std::vector<TokenStream> segments(plan.size());
+    std::vector<diagnostics::DiagnosticList> segment_diagnostics(plan.size());
+    auto lex_chunk = [&](std::size_t i) {
+        std::size_t begin = plan[i].begin;
+        std::size_t end = i + 1 < plan.size() ? plan[i + 1].begin : source.size();
+        segments[i] = run_scanner(source.substr(begin, end - begin), &segment_diagnostics[i]);
+    };
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < plan.size(); ++i) {
+        workers.emplace_back(lex_chunk, i);
+    }
+    lex_chunk(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // Splice the segments, rebasing byte offsets recorded relative to each
+    // chunk (diagnostic line numbers still need the per-chunk base, since
+    // each chunk's scanner computed them from its own substring). Interior
+    // Eof markers are dropped; the final chunk's Eof survives as the stream
+    // terminator.
+    std::size_t total = 0;
+    for (const auto& segment : segments) {
+        total += segment.size();
+    }
+    TokenStream tokens;
+    tokens.reserve(total);
+    for (std::size_t i = 0; i < plan.size(); ++i) {
+        const bool last = i + 1 == plan.size();
+        for (Token token : segments[i]) {
+            if (token.kind == TokenKind::Eof && !last) {
+                continue;
+            }
+            token.offset += plan[i].begin;
+            tokens.push_back(token);
+        }
+        for (diagnostics::Diagnostic diagnostic : segment_diagnostics[i]) {
+            if (diagnostic.line > 0) {
+                diagnostic.line += plan[i].line - 1;
+            }
+            if (diagnostics) {
+                diagnostics->push_back(std::move(diagnostic));
+            } else {
+                // Fail-fast mode: surface the earliest error the way
+                // Scanner::report would have thrown it.
+                throw std::runtime_error(diagnostics::render(diagnostic));
+            }
+        }
+    }
+    return tokens;
+}
+
+}  // namespace
+
+// Holds either a live scanner or an already-materialized stream behind the
+// same three-slot ring: the consumed token, the current token, and one token
+// of lookahead. Only that window ever exists in streaming mode.
+class TokenCursor::Impl {
+   public:
+    Impl(std::string_view source, diagnostics::DiagnosticList* diagnostics)
+        : scanner_(std::in_place, source, diagnostics) {
+        prime();
+    }
+
+    explicit Impl(const TokenStream& tokens) : tokens_(&tokens) { prime(); }
+
+    const Token& current() const { return slots_[current_slot_]; }
+
+    const Token& peek() const { return slots_[next_slot_]; }
+
+    const Token& consume() {
+        std::size_t consumed = current_slot_;
+        current_slot_ = next_slot_;
+        next_slot_ = (next_slot_ + 1) % 3;
+        slots_[next_slot_] =
+            slots_[current_slot_].kind == TokenKind::Eof ? slots_[current_slot_] : produce();
+        ++position_;
+        return slots_[consumed];
+    }
+
+    std::size_t position() const { return position_; }
+
+   private:
+    void prime() {
+        slots_[0] = produce();
+        slots_[1] = slots_[0].kind == TokenKind::Eof ? slots_[0] : produce();
+    }
+
+    Token produce() {
+        if (scanner_) {
+            return scanner_->next();
+        }
+        if (index_ < tokens_->size()) {
+            return (*tokens_)[index_++];
+        }
+        return tokens_->back();  // tokenize always terminates the stream with Eof
+    }
+
+    std::optional<Scanner> scanner_;
+    const TokenStream* tokens_ = nullptr;
+    std::size_t index_ = 0;
+    Token slots_[3] = {};
+    std::size_t current_slot_ = 0;
+    std::size_t next_slot_ = 1;
+    std::size_t position_ = 0;
+};
+
+TokenCursor::TokenCursor(std::string_view source, diagnostics::DiagnosticList* diagnostics)
+    : impl_(std::make_unique<Impl>(source, diagnostics)) {}
+
+TokenCursor::TokenCursor(const TokenStream& tokens) : impl_(std::make_unique<Impl>(tokens)) {}
+
+TokenCursor::~TokenCursor() = default;
+
+const Token& TokenCursor::current() const {
+    return impl_->current();
+}
+
+const Token& TokenCursor::peek() const {
+    return impl_->peek();
+}
+
+const Token& TokenCursor::consume() {
+    return impl_->consume();
+}
+
+std::size_t TokenCursor::position() const {
+    return impl_->position();
+}
+
+const char* token_kind_name(TokenKind kind) {
+    switch (kind) {
+        case TokenKind::Eof: return "EOF";
+        case TokenKind::Newline: return "NEWLINE";
+        case TokenKind::Name: return "NAME";
+        case TokenKind::Number: return "NUMBER";
+        case TokenKind::String: return "STRING";
+        case TokenKind::Op: return "OP";
+        case TokenKind::Lparen: return "LPAREN";
+        case TokenKind::Rparen: return "RPAREN";
+        case TokenKind::Lbrace: return "LBRACE";
+        case TokenKind::Rbrace: return "RBRACE";
+        case TokenKind::Lbracket: return "LBRACKET";
+        case TokenKind::Rbracket: return "RBRACKET";
+        case TokenKind::Comma: return "COMMA";
+        case TokenKind::Colon: return "COLON";
+        case TokenKind::Dot: return "DOT";
+        case TokenKind::Semicolon: return "SEMICOLON";
+        case TokenKind::Let: return "LET";
+        case TokenKind::Fn: return "FN";
+        case TokenKind::Function: return "FUNCTION";
+        case TokenKind::Return: return "RETURN";
+        case TokenKind::If: return "IF";
+        case TokenKind::Else: return "ELSE";
+        case TokenKind::While: return "WHILE";
+        case TokenKind::For: return "FOR";
+        case TokenKind::In: return "IN";
+        case TokenKind::True: return "TRUE";
+        case TokenKind::False: return "FALSE";
+        case TokenKind::Null: return "NULL";
+        case TokenKind::Import: return "IMPORT";
+        case TokenKind::As: return "AS";
+        case TokenKind::From: return "FROM";
+        case TokenKind::Const: return "CONST";
+        case TokenKind::Export: return "EXPORT";
+        case TokenKind::Default: return "DEFAULT";
+        case TokenKind::Spawn: return "SPAWN";
+    }
+    return "UNKNOWN";
+}
+
+bool is_keyword(std::string_view value) {
+    return keyword_kind(value) != TokenKind::Name;
+}
+
+TokenKind keyword_kind(std::string_view value) {
+    if (value.empty()) {
+        return TokenKind::Name;
+    }
+    const KeywordEntry& entry = kKeywords[keyword_slot(value)];
+    return entry.text == value ? entry.kind : TokenKind::Name;
+}
+
+std::string decode_string_literal(std::string_view raw) {
     if (raw.size() < 2) {
-        return raw;
+        return std::string(raw);
     }
-    std::string content = raw.substr(1, raw.size() - 2);
+    std::string_view content = raw.substr(1, raw.size() - 2);
     std::string result;
     result.reserve(content.size());
     for (std::size_t i = 0; i < content.size(); ++i) {
@@ -97,25 +648,36 @@ std::string decode_string_literal(const std::string& raw) {
     return result;
 }
 
-}  // namespace
+TokenStream tokenize_parallel(std::string_view source, unsigned jobs) {
+    return run_parallel(source, nullptr, jobs);
+}
+
+TokenStream tokenize_parallel(std::string_view source, diagnostics::DiagnosticList& diagnostics,
+                              unsigned jobs) {
+    return run_parallel(source, &diagnostics, jobs);
+}
 
-bool is_keyword(const std::string& value) {
-    return kKeywords.contains(value);
+TokenStream tokenize(std::string_view source) {
+    return run_scanner(source, nullptr);
 }
 
-TokenStream tokenize(const std::string& source) {
+TokenStream tokenize(std::string_view source, diagnostics::DiagnosticList& diagnostics) {
+    return run_scanner(source, &diagnostics);
+}
+
+TokenStream tokenize_regex(std::string_view source) {
     TokenStream tokens;
     std::size_t index = 0;
     int line = 1;
     int column = 1;
     while (index < source.size()) {
-        std::string_view remaining(source.c_str() + index, source.size() - index);
+        std::string_view remaining(source.data() + index, source.size() - index);
         if (remaining.substr(0, 2) == "/*") {
             std::size_t end = remaining.find("*/");
             if (end == std::string_view::npos) {
                 throw std::runtime_error("Unterminated block comment at line " + std::to_string(line));
             }
-            std::string value = std::string(remaining.substr(0, end + 2));
+            std::string_view value = remaining.substr(0, end + 2);
             int newline_count = static_cast<int>(std::count(value.begin(), value.end(), '\n'));
             line += newline_count;
             if (newline_count > 0) {
@@ -128,38 +690,36 @@ TokenStream tokenize(const std::string& source) {
             continue;
         }
         std::cmatch match;
-        std::string kind;
+        const Pattern* matched = nullptr;
         for (const auto& pattern : token_patterns()) {
             if (std::regex_search(remaining.begin(), remaining.end(), match, pattern.regex,
                                    std::regex_constants::match_continuous)) {
-                kind = pattern.name;
+                matched = &pattern;
                 break;
             }
         }
-        if (!match.ready() || kind.empty()) {
+        if (!matched) {
             throw std::runtime_error("Unexpected character '" + std::string(1, source[index]) + "' at line " +
                                      std::to_string(line) + " column " + std::to_string(column));
         }
-        std::string value = match.str();
-        if (kind == "NEWLINE") {
-            tokens.push_back({kind, value, line, column});
+        std::string_view value = remaining.substr(0, match.length());
+        if (matched->kind == TokenKind::Newline) {
+            tokens.push_back({TokenKind::Newline, value, index});
             ++line;
             column = 1;
-        } else if (kind == "SKIP" || kind == "COMMENT") {
+        } else if (matched->skip) {
             column += static_cast<int>(value.size());
         } else {
-            if (kind == "NAME" && is_keyword(value)) {
-                kind = uppercase(value);
-            }
-            if (kind == "STRING") {
-                value = decode_string_literal(value);
+            TokenKind kind = matched->kind;
+            if (kind == TokenKind::Name) {
+                kind = keyword_kind(value);
             }
-            tokens.push_back({kind, value, line, column});
+            tokens.push_back({kind, value, index});
             column += static_cast<int>(match.length());
         }
         index += match.length();
     }
-    tokens.push_back({"EOF", "", line, column});
+    tokens.push_back({TokenKind::Eof, {}, source.size()});
     return tokens;
 }
 
@@ -0,0 +1,560 @@
+#include "trif/lsp.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "trif/ast.hpp"
+#include "trif/diagnostics.hpp"
+#include "trif/lexer.hpp"
+#include "trif/parser.hpp"
+
+namespace trif::lsp {
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Minimal JSON reader/writer. The server only needs to pull a handful of
+// fields out of each request and echo ids back, so a small recursive-descent
+// reader over an in-memory value keeps the binary free of dependencies, the
+// same way the daemon hand-rolls its line protocol.
+
+struct Json {
+    enum class Kind { Null, Bool, Number, String, Array, Object };
+    Kind kind = Kind::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string text;
+    std::vector<Json> items;
+    std::vector<std::pair<std::string, Json>> members;
+
+    const Json* find(std::string_view key) const {
+        if (kind != Kind::Object) {
+            return nullptr;
+        }
+        for (const auto& member : members) {
+            if (member.first == key) {
+                return &member.second;
+            }
+        }
+        return nullptr;
+    }
+};
+
+class JsonReader {
+   public:
+    explicit JsonReader(std::string_view text) : text_(text) {}
+
+    Json parse() {
+        Json value = parse_value();
+        skip_whitespace();
+        if (index_ != text_.size()) {
+            fail();
+        }
+        return value;
+    }
+
+   private:
+    [[noreturn]] void fail() { throw std::runtime_error("Malformed JSON message"); }
+
+    char peek() {
+        if (index_ >= text_.size()) {
+            fail();
+        }
+        return text_[index_];
+    }
+
+    char next() {
+        char c = peek();
+        ++index_;
+        return c;
+    }
+
+    void skip_whitespace() {
+        while (index_ < text_.size()) {
+            char c = text_[index_];
+            if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+                break;
+            }
+            ++index_;
+        }
+    }
+
+    void expect_literal(std::string_view literal) {
+        if (text_.substr(index_, literal.size()) != literal) {
+            fail();
+        }
+        index_ += literal.size();
+    }
+
+    Json parse_value() {
+        skip_whitespace();
+        switch (peek()) {
+            case '{':
+                return parse_object();
+            case '[':
+                return parse_array();
+            case '"': {
+                Json value;
+                value.kind = Json::Kind::String;
+                value.text = parse_string();
+                return value;
+            }
+            case 't': {
+                expect_literal("true");
+                Json value;
+                value.kind = Json::Kind::Bool;
+                value.boolean = true;
+                return value;
+            }
+            case 'f': {
+                expect_literal("false");
+                Json value;
+                value.kind = Json::Kind::Bool;
+                return value;
+            }
+            case 'n':
+                expect_literal("null");
+                return Json{};
+            default:
+                return parse_number();
+        }
+    }
+
+    Json parse_object() {
+        Json value;
+        value.kind = Json::Kind::Object;
+        next();  // '{'
+        skip_whitespace();
+        if (peek() == '}') {
+            next();
+            return value;
+        }
+        for (;;) {
+            skip_whitespace();
+            std::string key = parse_string();
+            skip_whitespace();
+            if (next() != ':') {
+                fail();
+            }
+            value.members.emplace_back(std::move(key), parse_value());
+            skip_whitespace();
+            char c = next();
+            if (c == '}') {
+                return value;
+            }
+            if (c != ',') {
+                fail();
+            }
+        }
+    }
+
+    Json parse_array() {
+        Json value;
+        value.kind = Json::Kind::Array;
+        next();  // '['
+        skip_whitespace();
+        if (peek() == ']') {
+            next();
+            return value;
+        }
+        for (;;) {
+            value.items.push_back(parse_value());
+            skip_whitespace();
+            char c = next();
+            if (c == ']') {
+                return value;
+            }
+            if (c != ',') {
+                fail();
+            }
+        }
+    }
+
+    std::string parse_string() {
+        if (next() != '"') {
+            fail();
+        }
+        std::string result;
+        for (;;) {
+            char c = next();
+            if (c == '"') {
+                return result;
+            }
+            if (c != '\\') {
+                result.push_back(c);
+                continue;
+            }
+            char escape = next();
+            switch (escape) {
+                case '"':
+                case '\\':
+                case '/':
+                    result.push_back(escape);
+                    break;
+                case 'b':
+                    result.push_back('\b');
+                    break;
+                case 'f':
+                    result.push_back('\f');
+                    break;
+                case 'n':
+                    result.push_back('\n');
+                    break;
+                case 'r':
+                    result.push_back('\r');
+                    break;
+                case 't':
+                    result.push_back('\t');
+                    break;
+                case 'u':
+                    append_utf8(result, parse_hex4());
+                    break;
+                default:
+                    fail();
+            }
+        }
+    }
+
+    unsigned parse_hex4() {
+        unsigned value = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = next();
+            value <<= 4;
+            if (c >= '0' && c <= '9') {
+                value |= static_cast<unsigned>(c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                value |= static_cast<unsigned>(c - 'a' + 10);
+            } else if (c >= 'A' && c <= 'F') {
+                value |= static_cast<unsigned>(c - 'A' + 10);
+            } else {
+                fail();
+            }
+        }
+        return value;
+    }
+
+    static void append_utf8(std::string& out, unsigned code_point) {
+        if (code_point < 0x80) {
+            out.push_back(static_cast<char>(code_point));
+        } else if (code_point < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+            out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        }
+    }
+
+    Json parse_number() {
+        std::size_t start = index_;
+        if (peek() == '-') {
+            next();
+        }
+        while (index_ < text_.size() &&
+               (std::isdigit(static_cast<unsigned char>(text_[index_])) || text_[index_] == '.' ||
+                text_[index_] == 'e' || text_[index_] == 'E' || text_[index_] == '+' ||
+                text_[index_] == '-')) {
+            ++index_;
+        }
+        if (index_ == start) {
+            fail();
+        }
+        Json value;
+        value.kind = Json::Kind::Number;
+        value.number = std::stod(std::string(text_.substr(start, index_ - start)));
+        return value;
+    }
+
+    std::string_view text_;
+    std::size_t index_ = 0;
+};
+
+std::string quote(std::string_view text) {
+    std::string result = "\"";
+    for (char c : text) {
+        switch (c) {
+            case '"':
+                result += "\\\"";
+                break;
+            case '\\':
+                result += "\\\\";
+                break;
+            case '\n':
+                result += "\\n";
+                break;
+            case '\r':
+                result += "\\r";
+                break;
+            case '\t':
+                result += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof buffer, "\\u%04x", c);
+                    result += buffer;
+                } else {
+                    result.push_back(c);
+                }
+        }
+    }
+    result.push_back('"');
+    return result;
+}
+
+// Serializes a request id for echoing back; only numbers and strings occur.
+std::string render_id(const Json* id) {
+    if (id == nullptr || id->kind == Json::Kind::Null) {
+        return "null";
+    }
+    if (id->kind == Json::Kind::String) {
+        return quote(id->text);
+    }
+    auto integral = static_cast<std::int64_t>(id->number);
+    if (static_cast<double>(integral) == id->number) {
+        return std::to_string(integral);
+    }
+    return std::to_string(id->number);
+}
+
+// ---------------------------------------------------------------------------
+// Framing: each message is "Content-Length: N" headers, a blank line, then N
+// bytes of JSON, in both directions.
+
+bool read_message(std::istream& in, std::string& payload) {
+    std::size_t length = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            if (length == 0) {
+                continue;  // stray blank line between messages
+            }
+            payload.resize(length);
+            in.read(payload.data(), static_cast<std::streamsize>(length));
+            return static_cast<std::size_t>(in.gcount()) == length;
+        }
+        constexpr std::string_view kHeader = "Content-Length:";
+        if (line.size() > kHeader.size() && std::string_view(line).starts_with(kHeader)) {
+            length = std::stoul(line.substr(kHeader.size()));
+        }
+    }
+    return false;
+}
+
+void send_payload(const std::string& body) {
+    std::cout << "Content-Length: " << body.size() << "\r\n\r\n" << body;
+    std::cout.flush();
+}
+
+void send_result(const Json* id, const std::string& result) {
+    send_payload("{\"jsonrpc\":\"2.0\",\"id\":" + render_id(id) + ",\"result\":" + result + "}");
+}
+
+void send_error(const Json* id, int code, const std::string& message) {
+    send_payload("{\"jsonrpc\":\"2.0\",\"id\":" + render_id(id) + ",\"error\":{\"code\":" +
+                 std::to_string(code) + ",\"message\":" + quote(message) + "}}");
+}
+
+// ---------------------------------------------------------------------------
+// Document store. The source, arena, and module for each open file stay
+// resident between requests; a change replaces the buffer and re-runs the
+// recovering lexer and parser, which is cheap enough to do per keystroke.
+
+struct Document {
+    std::string source;
+    std::unique_ptr<ast::Arena> arena;
+    ast::ModulePtr module = nullptr;
+    diagnostics::DiagnosticList diagnostics;
+    // Byte offset of each line start, for span -> position conversion.
+    std::vector<std::size_t> line_starts;
+};
+
+void analyze(Document& document) {
+    document.arena = std::make_unique<ast::Arena>();
+    document.diagnostics.clear();
+    auto tokens = lexer::tokenize(document.source, document.diagnostics);
+    document.module = parser::parse(document.source, tokens, *document.arena, document.diagnostics);
+    document.line_starts.assign(1, 0);
+    for (std::size_t i = 0; i < document.source.size(); ++i) {
+        if (document.source[i] == '\n') {
+            document.line_starts.push_back(i + 1);
+        }
+    }
+}
+
+// "{"line":L,"character":C}" with LSP's 0-based coordinates.
+std::string render_position(const Document& document, std::size_t offset) {
+    auto it = std::upper_bound(document.line_starts.begin(), document.line_starts.end(), offset);
+    std::size_t line = static_cast<std::size_t>(it - document.line_starts.begin()) - 1;
+    std::size_t character = offset - document.line_starts[line];
+    return "{\"line\":" + std::to_string(line) + ",\"character\":" + std::to_string(character) +
+           "}";
+}
+
+std::string render_range(const Document& document, const ast::SourceSpan& span) {
+    return "{\"start\":" + render_position(document, span.begin) +
+           ",\"end\":" + render_position(document, span.end) + "}";
+}
+
+void publish_diagnostics(const std::string& uri, const Document& document) {
+    std::string body;
+    for (const auto& diagnostic : document.diagnostics) {
+        if (!body.empty()) {
+            body += ",";
+        }
+        int line = diagnostic.line > 0 ? diagnostic.line - 1 : 0;
+        int column = diagnostic.column > 0 ? diagnostic.column - 1 : 0;
+        body += "{\"range\":{\"start\":{\"line\":" + std::to_string(line) +
+                ",\"character\":" + std::to_string(column) +
+                "},\"end\":{\"line\":" + std::to_string(line) +
+                ",\"character\":" + std::to_string(column + 1) +
+                "}},\"severity\":1,\"source\":\"trifc\",\"message\":" +
+                quote(diagnostic.message) + "}";
+    }
+    send_payload(
+        "{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/publishDiagnostics\",\"params\":{"
+        "\"uri\":" +
+        quote(uri) + ",\"diagnostics\":[" + body + "]}}");
+}
+
+// Top-level functions and bindings as DocumentSymbol entries. Statement
+// spans are only recorded at module level (see Module::body_spans), which
+// matches what the outline view shows anyway.
+std::string render_document_symbols(const Document& document) {
+    constexpr int kSymbolKindFunction = 12;
+    constexpr int kSymbolKindVariable = 13;
+    std::string body;
+    if (document.module == nullptr) {
+        return "[]";
+    }
+    for (std::size_t i = 0; i < document.module->body.size(); ++i) {
+        const ast::NodePtr statement = document.module->body[i];
+        std::string name;
+        int kind = 0;
+        if (statement->kind == ast::NodeKind::FunctionDef) {
+            name = intern::spelling(static_cast<const ast::FunctionDef*>(statement)->name);
+            kind = kSymbolKindFunction;
+        } else if (statement->kind == ast::NodeKind::Let) {
+            name = intern::spelling(static_cast<const ast::Let*>(statement)->name);
+            kind = kSymbolKindVariable;
+        } else {
+            continue;
+        }
+        ast::SourceSpan span;
+        if (i < document.module->body_spans.size()) {
+            span = document.module->body_spans[i];
+        }
+        std::string range = render_range(document, span);
+        if (!body.empty()) {
+            body += ",";
+        }
+        body += "{\"name\":" + quote(name) + ",\"kind\":" + std::to_string(kind) +
+                ",\"range\":" + range + ",\"selectionRange\":" + range + "}";
+    }
+    return "[" + body + "]";
+}
+
+const Json* document_uri(const Json& params) {
+    const Json* text_document = params.find("textDocument");
+    return text_document != nullptr ? text_document->find("uri") : nullptr;
+}
+
+}  // namespace
+
+int serve() {
+    std::unordered_map<std::string, Document> documents;
+    bool shutdown_requested = false;
+    std::string payload;
+    while (read_message(std::cin, payload)) {
+        Json message;
+        try {
+            message = JsonReader(payload).parse();
+        } catch (const std::exception&) {
+            continue;  // drop unparseable frames rather than dying mid-session
+        }
+        const Json* method_value = message.find("method");
+        if (method_value == nullptr || method_value->kind != Json::Kind::String) {
+            continue;
+        }
+        const std::string& method = method_value->text;
+        const Json* id = message.find("id");
+        const Json* params = message.find("params");
+
+        if (method == "initialize") {
+            send_result(id,
+                        "{\"capabilities\":{\"textDocumentSync\":1,"
+                        "\"documentSymbolProvider\":true},"
+                        "\"serverInfo\":{\"name\":\"trifc\"}}");
+        } else if (method == "shutdown") {
+            shutdown_requested = true;
+            send_result(id, "null");
+        } else if (method == "exit") {
+            return shutdown_requested ? 0 : 1;
+        } else if (method == "textDocument/didOpen") {
+            const Json* text_document = params != nullptr ? params->find("textDocument") : nullptr;
+            const Json* uri = text_document != nullptr ? text_document->find("uri") : nullptr;
+            const Json* text = text_document != nullptr ? text_document->find("text") : nullptr;
+            if (uri == nullptr || text == nullptr) {
+                continue;
+            }
+            Document& document = documents[uri->text];
+            document.source = text->text;
+            analyze(document);
+            publish_diagnostics(uri->text, document);
+        } else if (method == "textDocument/didChange") {
+            const Json* uri = params != nullptr ? document_uri(*params) : nullptr;
+            const Json* changes = params != nullptr ? params->find("contentChanges") : nullptr;
+            if (uri == nullptr || changes == nullptr || changes->items.empty()) {
+                continue;
+            }
+            // Full-document sync: the last change entry carries the whole buffer.
+            const Json* text = changes->items.back().find("text");
+            if (text == nullptr) {
+                continue;
+            }
+            Document& document = documents[uri->text];
+            document.source = text->text;
+            analyze(document);
+            publish_diagnostics(uri->text, document);
+        } else if (method == "textDocument/didClose") {
+            const Json* uri = params != nullptr ? document_uri(*params) : nullptr;
+            if (uri == nullptr) {
+                continue;
+            }
+            documents.erase(uri->text);
+            send_payload(
+                "{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/publishDiagnostics\","
+                "\"params\":{\"uri\":" +
+                quote(uri->text) + ",\"diagnostics\":[]}}");
+        } else if (method == "textDocument/documentSymbol") {
+            const Json* uri = params != nullptr ? document_uri(*params) : nullptr;
+            auto it = uri != nullptr ? documents.find(uri->text) : documents.end();
+            if (it == documents.end()) {
+                send_result(id, "[]");
+            } else {
+                send_result(id, render_document_symbols(it->second));
+            }
+        } else if (id != nullptr) {
+            send_error(id, -32601, "Method not found: " + method);
+        }
+        // Remaining notifications (initialized, setTrace, ...) need no reply.
+    }
+    return shutdown_requested ? 0 : 1;
+}
+
+}  // namespace trif::lsp
@@ -1,22 +1,60 @@
+#include <atomic>
 #include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <mutex>
 #include <optional>
+#include <set>
+#include <sstream>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
+#include "trif/codegen.hpp"
 #include "trif/compiler.hpp"
+#include "trif/daemon.hpp"
+#include "trif/diagnostics.hpp"
+#include "trif/graph.hpp"
+#include "trif/lsp.hpp"
+#include "trif/watch.hpp"
 
 namespace {
 
 struct Arguments {
-    std::optional<std::string> input;
+    std::vector<std::string> inputs;
     std::optional<std::string> output;
+    std::optional<std::string> output_dir;
+    std::optional<std::string> cache_dir;
+    std::optional<std::string> daemon_socket;
     std::string target = "python";
     bool aggressive_errors = false;
+    bool legacy_lexer = false;
+    bool parallel_lexer = false;
+    bool parallel_codegen = false;
+    bool batch = false;
+    bool emit_ast = false;
+    bool shared_preamble = false;
+    bool optimize = false;
+    bool watch = false;
+    bool lsp = false;
+    bool compile_graph = false;
+    bool time_report = false;
+    unsigned jobs = 0;  // 0 = one per hardware thread
 };
 
+void append_response_file(const std::string& path, std::vector<std::string>& inputs) {
+    std::ifstream stream(path);
+    if (!stream) {
+        throw std::runtime_error("Unable to open response file: " + path);
+    }
+    std::string entry;
+    while (stream >> entry) {
+        inputs.push_back(entry);
+    }
+}
+
 Arguments parse_arguments(int argc, char** argv) {
     Arguments args;
     for (int i = 1; i < argc; ++i) {
@@ -25,17 +63,127 @@ Arguments parse_arguments(int argc, char** argv) {
             args.target = argv[++i];
         } else if (value == "--output" && i + 1 < argc) {
             args.output = argv[++i];
+        } else if (value == "--output-dir" && i + 1 < argc) {
+            args.output_dir = argv[++i];
+        } else if (value == "--cache-dir" && i + 1 < argc) {
+            args.cache_dir = argv[++i];
+        } else if (value == "--daemon" && i + 1 < argc) {
+            args.daemon_socket = argv[++i];
         } else if (value == "--aggressive-errors") {
             args.aggressive_errors = true;
-        } else if (!args.input) {
-            args.input = std::string(value);
+        } else if (value == "--legacy-lexer") {
+            args.legacy_lexer = true;
+        } else if (value == "--parallel-lexer") {
+            args.parallel_lexer = true;
+        } else if (value == "--parallel-codegen") {
+            args.parallel_codegen = true;
+        } else if (value == "--batch") {
+            args.batch = true;
+        } else if (value == "--emit-ast") {
+            args.emit_ast = true;
+        } else if (value == "--shared-preamble") {
+            args.shared_preamble = true;
+        } else if (value == "-O" || value == "--optimize") {
+            args.optimize = true;
+        } else if (value == "--watch") {
+            args.watch = true;
+        } else if (value == "--lsp") {
+            args.lsp = true;
+        } else if (value == "--compile-graph") {
+            args.compile_graph = true;
+        } else if (value == "--time-report") {
+            args.time_report = true;
+        } else if (value == "--jobs" && i + 1 < argc) {
+            args.jobs = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (value.starts_with("@")) {
+            append_response_file(std::string(value.substr(1)), args.inputs);
+        } else if (args.batch || args.inputs.empty()) {
+            args.inputs.emplace_back(value);
         } else {
             throw std::runtime_error("Unrecognized argument: " + std::string(value));
         }
     }
+    if (args.target.find(',') != std::string::npos) {
+        if (args.emit_ast) {
+            throw std::runtime_error("--emit-ast expects a single target");
+        }
+        if (args.output) {
+            throw std::runtime_error("--output is ambiguous with multiple targets; use --output-dir");
+        }
+        if (args.watch) {
+            throw std::runtime_error("--watch expects a single target");
+        }
+    }
+    if (args.shared_preamble) {
+        if (args.emit_ast || args.compile_graph) {
+            throw std::runtime_error(
+                "--shared-preamble cannot be combined with --emit-ast or --compile-graph");
+        }
+        if (args.target.find("python") == std::string::npos) {
+            throw std::runtime_error("--shared-preamble only applies to the python target");
+        }
+    }
+    if (args.parallel_lexer && args.legacy_lexer) {
+        throw std::runtime_error("--parallel-lexer cannot be combined with --legacy-lexer");
+    }
+    if (args.lsp && (!args.inputs.empty() || args.batch || args.watch || args.daemon_socket)) {
+        throw std::runtime_error("--lsp takes no inputs and runs alone over stdio");
+    }
+    if (args.watch && (args.batch || args.emit_ast || args.optimize)) {
+        throw std::runtime_error("--watch cannot be combined with --batch, --emit-ast, or -O");
+    }
+    if (args.compile_graph) {
+        if (args.batch || args.watch || args.emit_ast) {
+            throw std::runtime_error(
+                "--compile-graph cannot be combined with --batch, --watch, or --emit-ast");
+        }
+        if (args.target.find(',') != std::string::npos) {
+            throw std::runtime_error("--compile-graph expects a single target");
+        }
+    }
     return args;
 }
 
+// Splits a comma-separated --target value, e.g. "python,javascript".
+std::vector<std::string> split_targets(const std::string& target) {
+    std::vector<std::string> targets;
+    std::size_t start = 0;
+    for (;;) {
+        std::size_t comma = target.find(',', start);
+        std::string entry = target.substr(start, comma - start);
+        if (entry.empty()) {
+            throw std::runtime_error("Malformed --target list: " + target);
+        }
+        targets.push_back(std::move(entry));
+        if (comma == std::string::npos) {
+            break;
+        }
+        start = comma + 1;
+    }
+    return targets;
+}
+
+std::string output_extension(const std::string& target, bool emit_ast) {
+    if (emit_ast) {
+        return ".trifb";
+    }
+    if (target == "javascript" || target == "js") {
+        return ".js";
+    }
+    if (target == "cpp" || target == "c++") {
+        return ".cpp";
+    }
+    return ".py";
+}
+
+std::filesystem::path mapped_output_path(const Arguments& args, const std::string& input,
+                                         const std::string& target) {
+    std::filesystem::path source(input);
+    std::filesystem::path directory = args.output_dir ? std::filesystem::path(*args.output_dir)
+                                                      : source.parent_path();
+    return directory / source.stem().concat(output_extension(target, args.emit_ast));
+}
+
 void write_output(const std::optional<std::string>& path, const std::string& content) {
     if (!path) {
         std::cout << content << std::endl;
@@ -48,22 +196,190 @@ void write_output(const std::optional<std::string>& path, const std::string& con
     stream << content;
 }
 
+// One stderr block per compiled file; kept to a few fixed-width lines so CI
+// logs stay grep-able.
+void print_time_report(const std::string& input, const trif::compiler::CompileStats& stats) {
+    std::ostringstream report;
+    report << "trifc: time report for " << input << "\n" << std::fixed << std::setprecision(3)
+           << "  lex      " << stats.lex_ms << " ms  (" << stats.tokens << " tokens)\n"
+           << "  parse    " << stats.parse_ms << " ms  (" << stats.nodes << " nodes)\n"
+           << "  optimize " << stats.optimize_ms << " ms\n"
+           << "  codegen  " << stats.codegen_ms << " ms  (" << stats.output_bytes << " bytes)\n";
+    std::cerr << report.str();
+}
+
+trif::compiler::CompileOptions make_options(const Arguments& args) {
+    trif::compiler::CompileOptions options;
+    options.target = args.target;
+    options.shared_preamble = args.shared_preamble;
+    options.aggressive_errors = args.aggressive_errors;
+    options.use_regex_lexer = args.legacy_lexer;
+    options.parallel_lexer = args.parallel_lexer;
+    options.parallel_codegen = args.parallel_codegen;
+    options.cache_dir = args.cache_dir;
+    options.emit_ast = args.emit_ast;
+    options.optimize = args.optimize;
+    options.time_report = args.time_report;
+    return options;
+}
+
+// Writes the shared _trif_boot.py bootstrap into `directory`; shared-preamble
+// Python outputs import it instead of carrying their own copy.
+void write_boot_module(const std::filesystem::path& directory) {
+    auto path = directory.empty() ? std::filesystem::path("_trif_boot.py")
+                                  : directory / "_trif_boot.py";
+    std::ofstream stream(path);
+    if (!stream) {
+        throw std::runtime_error("Unable to write to output path: " + path.string());
+    }
+    stream << trif::codegen::python_boot_module();
+}
+
+// Compiles every input on a worker pool; all files are attempted before the
+// combined status is reported.
+int run_batch(const Arguments& args) {
+    if (args.shared_preamble) {
+        // One boot module per directory that will receive Python output.
+        std::set<std::filesystem::path> directories;
+        for (const auto& input : args.inputs) {
+            directories.insert(args.output_dir ? std::filesystem::path(*args.output_dir)
+                                               : std::filesystem::path(input).parent_path());
+        }
+        for (const auto& directory : directories) {
+            if (!directory.empty()) {
+                std::filesystem::create_directories(directory);
+            }
+            write_boot_module(directory);
+        }
+    }
+    auto options = make_options(args);
+    auto targets = split_targets(args.target);
+    if (args.output_dir) {
+        std::filesystem::create_directories(*args.output_dir);
+    }
+    std::atomic<std::size_t> next{0};
+    std::atomic<int> failures{0};
+    std::mutex log_mutex;
+    unsigned worker_count = args.jobs ? args.jobs : std::thread::hardware_concurrency();
+    worker_count = std::max(1u, std::min<unsigned>(worker_count, args.inputs.size()));
+    auto worker = [&] {
+        trif::compiler::Compiler compiler;
+        for (std::size_t i = next.fetch_add(1); i < args.inputs.size(); i = next.fetch_add(1)) {
+            const std::string& input = args.inputs[i];
+            try {
+                auto result = targets.size() > 1 ? compiler.compile_file(input, targets, options)
+                                                 : compiler.compile_file(input, options);
+                if (!result.diagnostics.empty()) {
+                    std::scoped_lock lock(log_mutex);
+                    for (const auto& diagnostic : result.diagnostics) {
+                        std::cerr << "trifc: " << input << ": "
+                                  << trif::diagnostics::render(diagnostic) << std::endl;
+                    }
+                    ++failures;
+                    continue;
+                }
+                for (const auto& output : result.outputs) {
+                    write_output(mapped_output_path(args, input, output.target).string(),
+                                 output.text);
+                }
+                if (result.output_text) {
+                    write_output(mapped_output_path(args, input, args.target).string(),
+                                 *result.output_text);
+                }
+                if (args.time_report) {
+                    std::scoped_lock lock(log_mutex);
+                    print_time_report(input, result.stats);
+                }
+            } catch (const std::exception& exc) {
+                std::scoped_lock lock(log_mutex);
+                std::cerr << "trifc: " << input << ": " << exc.what() << std::endl;
+                ++failures;
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < worker_count; ++i) {
+        workers.emplace_back(worker);
+    }
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    return failures == 0 ? 0 : 1;
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
     try {
         auto args = parse_arguments(argc, argv);
-        if (!args.input) {
+        if (args.lsp) {
+            return trif::lsp::serve();
+        }
+        if (args.daemon_socket) {
+            return trif::daemon::serve(*args.daemon_socket, make_options(args));
+        }
+        if (args.inputs.empty()) {
             throw std::runtime_error("No input file provided");
         }
+        if (args.batch) {
+            return run_batch(args);
+        }
+        if (args.compile_graph) {
+            return trif::graph::compile_graph(args.inputs.front(), make_options(args),
+                                              args.output_dir, args.jobs);
+        }
+        if (args.watch) {
+            const std::string& input = args.inputs.front();
+            std::string output = args.output ? *args.output
+                                             : mapped_output_path(args, input, args.target).string();
+            if (args.shared_preamble) {
+                write_boot_module(std::filesystem::path(output).parent_path());
+            }
+            return trif::watch::serve(input, output, make_options(args));
+        }
         trif::compiler::Compiler compiler;
-        trif::compiler::CompileOptions options;
-        options.target = args.target;
-        options.aggressive_errors = args.aggressive_errors;
-        auto result = compiler.compile_file(*args.input, options);
+        auto targets = split_targets(args.target);
+        if (targets.size() > 1) {
+            auto result = compiler.compile_file(args.inputs.front(), targets, make_options(args));
+            if (!result.diagnostics.empty()) {
+                for (const auto& diagnostic : result.diagnostics) {
+                    std::cerr << "trifc: " << trif::diagnostics::render(diagnostic) << std::endl;
+                }
+                return 1;
+            }
+            for (const auto& output : result.outputs) {
+                write_output(mapped_output_path(args, args.inputs.front(), output.target).string(),
+                             output.text);
+                if (args.shared_preamble && output.target == "python") {
+                    write_boot_module(
+                        mapped_output_path(args, args.inputs.front(), output.target)
+                            .parent_path());
+                }
+            }
+            if (args.time_report) {
+                print_time_report(args.inputs.front(), result.stats);
+            }
+            return 0;
+        }
+        auto result = compiler.compile_file(args.inputs.front(), make_options(args));
+        if (!result.diagnostics.empty()) {
+            for (const auto& diagnostic : result.diagnostics) {
+                std::cerr << "trifc: " << trif::diagnostics::render(diagnostic) << std::endl;
+            }
+            return 1;
+        }
         if (result.output_text) {
+            if (args.shared_preamble) {
+                if (!args.output) {
+                    throw std::runtime_error("--shared-preamble requires --output");
+                }
+                write_boot_module(std::filesystem::path(*args.output).parent_path());
+            }
             write_output(args.output, *result.output_text);
         }
+        if (args.time_report) {
+            print_time_report(args.inputs.front(), result.stats);
+        }
     } catch (const std::exception& exc) {
         std::cerr << "trifc: " << exc.what() << std::endl;
         return 1;
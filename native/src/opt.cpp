@@ -0,0 +1,418 @@
+#include "trif/opt.hpp"
+
+#include <cmath>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace trif::opt {
+
+using namespace trif::ast;
+
+namespace {
+
+bool is_literal(const ExpressionPtr expr) {
+    switch (expr->kind) {
+        case NodeKind::Number:
+        case NodeKind::String:
+        case NodeKind::Boolean:
+        case NodeKind::Null:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool literal_truthy(const ExpressionPtr expr) {
+    switch (expr->kind) {
+        case NodeKind::Number:
+            return static_cast<Number*>(expr)->value != 0.0;
+        case NodeKind::String:
+            return !static_cast<String*>(expr)->value.empty();
+        case NodeKind::Boolean:
+            return static_cast<Boolean*>(expr)->value;
+        default:
+            return false;  // Null
+    }
+}
+
+ExpressionPtr make_number(Arena& arena, double value) {
+    return arena.create<Number>(value);
+}
+
+ExpressionPtr make_boolean(Arena& arena, bool value) {
+    return arena.create<Boolean>(value);
+}
+
+ExpressionPtr make_string(Arena& arena, std::string value) {
+    return arena.create<String>(std::move(value));
+}
+
+bool literals_equal(const ExpressionPtr left, const ExpressionPtr right) {
+    if (left->kind != right->kind) {
+        return false;
+    }
+    switch (left->kind) {
+        case NodeKind::Number:
+            return static_cast<Number*>(left)->value == static_cast<Number*>(right)->value;
+        case NodeKind::String:
+            return static_cast<String*>(left)->value == static_cast<String*>(right)->value;
+        case NodeKind::Boolean:
+            return static_cast<Boolean*>(left)->value == static_cast<Boolean*>(right)->value;
+        default:
+            return true;  // Null == Null
+    }
+}
+
+ExpressionPtr fold_expression(ExpressionPtr expr, Arena& arena);
+
+ExpressionPtr fold_binary(BinaryOp* node, Arena& arena) {
+    node->left = fold_expression(node->left, arena);
+    node->right = fold_expression(node->right, arena);
+    if (!is_literal(node->left) || !is_literal(node->right)) {
+        return node;
+    }
+    const std::string& op = node->op;
+    // Both targets' && and || evaluate to an operand, not a Boolean
+    // (Python `1 and 2` is 2), so fold to the operand short-circuiting
+    // selects rather than its truthiness.
+    if (op == "&&") {
+        return literal_truthy(node->left) ? node->right : node->left;
+    }
+    if (op == "||") {
+        return literal_truthy(node->left) ? node->left : node->right;
+    }
+    // Cross-kind comparisons are target-defined (Python `True == 1` is
+    // True, JS `1 == "1"` is true), so only same-kind pairs fold.
+    if (op == "==" && node->left->kind == node->right->kind) {
+        return make_boolean(arena, literals_equal(node->left, node->right));
+    }
+    if (op == "!=" && node->left->kind == node->right->kind) {
+        return make_boolean(arena, !literals_equal(node->left, node->right));
+    }
+    if (node->left->kind == NodeKind::String && node->right->kind == NodeKind::String && op == "+") {
+        return make_string(arena, static_cast<String*>(node->left)->value +
+                                      static_cast<String*>(node->right)->value);
+    }
+    if (node->left->kind == NodeKind::Number && node->right->kind == NodeKind::Number) {
+        double left = static_cast<Number*>(node->left)->value;
+        double right = static_cast<Number*>(node->right)->value;
+        if (op == "+") return make_number(arena, left + right);
+        if (op == "-") return make_number(arena, left - right);
+        if (op == "*") return make_number(arena, left * right);
+        if (op == "/" && right != 0.0) return make_number(arena, left / right);
+        if (op == "%" && right != 0.0) return make_number(arena, std::fmod(left, right));
+        if (op == "<") return make_boolean(arena, left < right);
+        if (op == "<=") return make_boolean(arena, left <= right);
+        if (op == ">") return make_boolean(arena, left > right);
+        if (op == ">=") return make_boolean(arena, left >= right);
+    }
+    return node;
+}
+
+ExpressionPtr fold_expression(ExpressionPtr expr, Arena& arena) {
+    switch (expr->kind) {
+        case NodeKind::BinaryOp:
+            return fold_binary(static_cast<BinaryOp*>(expr), arena);
+        case NodeKind::UnaryOp: {
+            auto* node = static_cast<UnaryOp*>(expr);
+            node->operand = fold_expression(node->operand, arena);
+            if (node->op == "-" && node->operand->kind == NodeKind::Number) {
+                return make_number(arena, -static_cast<Number*>(node->operand)->value);
+            }
+            if (node->op == "!" && is_literal(node->operand)) {
+                return make_boolean(arena, !literal_truthy(node->operand));
+            }
+            return node;
+        }
+        case NodeKind::Call: {
+            auto* node = static_cast<Call*>(expr);
+            node->func = fold_expression(node->func, arena);
+            for (auto& arg : node->args) {
+                arg = fold_expression(arg, arena);
+            }
+            return node;
+        }
+        case NodeKind::Attribute: {
+            auto* node = static_cast<Attribute*>(expr);
+            node->value = fold_expression(node->value, arena);
+            return node;
+        }
+        case NodeKind::ListLiteral: {
+            auto* node = static_cast<ListLiteral*>(expr);
+            for (auto& element : node->elements) {
+                element = fold_expression(element, arena);
+            }
+            return node;
+        }
+        case NodeKind::DictLiteral: {
+            auto* node = static_cast<DictLiteral*>(expr);
+            for (auto& [key, value] : node->pairs) {
+                key = fold_expression(key, arena);
+                value = fold_expression(value, arena);
+            }
+            return node;
+        }
+        default:
+            return expr;
+    }
+}
+
+void run_on_body(std::vector<NodePtr>& body, Arena& arena);
+
+// Folds subexpressions of one statement and recurses into nested bodies.
+void fold_statement(NodePtr stmt, Arena& arena) {
+    switch (stmt->kind) {
+        case NodeKind::Let: {
+            auto* let = static_cast<Let*>(stmt);
+            let->value = fold_expression(let->value, arena);
+            break;
+        }
+        case NodeKind::Assign: {
+            auto* assign = static_cast<Assign*>(stmt);
+            assign->value = fold_expression(assign->value, arena);
+            break;
+        }
+        case NodeKind::FunctionDef:
+            run_on_body(static_cast<FunctionDef*>(stmt)->body, arena);
+            break;
+        case NodeKind::ExportDefault: {
+            auto* node = static_cast<ExportDefault*>(stmt);
+            node->value = fold_expression(node->value, arena);
+            break;
+        }
+        case NodeKind::Return: {
+            auto* ret = static_cast<Return*>(stmt);
+            if (ret->value) {
+                ret->value = fold_expression(*ret->value, arena);
+            }
+            break;
+        }
+        case NodeKind::If: {
+            auto* branch = static_cast<If*>(stmt);
+            branch->test = fold_expression(branch->test, arena);
+            run_on_body(branch->body, arena);
+            run_on_body(branch->orelse, arena);
+            break;
+        }
+        case NodeKind::While: {
+            auto* loop = static_cast<While*>(stmt);
+            loop->test = fold_expression(loop->test, arena);
+            run_on_body(loop->body, arena);
+            break;
+        }
+        case NodeKind::For: {
+            auto* loop = static_cast<For*>(stmt);
+            loop->iterator = fold_expression(loop->iterator, arena);
+            run_on_body(loop->body, arena);
+            break;
+        }
+        case NodeKind::Spawn: {
+            auto* spawn = static_cast<Spawn*>(stmt);
+            spawn->call = fold_expression(spawn->call, arena);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// Folds every statement in `body`, then splices away branches whose test
+// folded to a constant.
+void run_on_body(std::vector<NodePtr>& body, Arena& arena) {
+    std::vector<NodePtr> rewritten;
+    rewritten.reserve(body.size());
+    for (std::size_t i = 0; i < body.size(); ++i) {
+        NodePtr stmt = body[i];
+        if (is_expression_kind(stmt->kind)) {
+            auto* expr = static_cast<Expression*>(stmt);
+            body[i] = fold_expression(expr, arena);
+            rewritten.push_back(body[i]);
+            continue;
+        }
+        fold_statement(stmt, arena);
+        if (stmt->kind == NodeKind::If) {
+            auto* branch = static_cast<If*>(stmt);
+            if (is_literal(branch->test)) {
+                auto& taken = literal_truthy(branch->test) ? branch->body : branch->orelse;
+                rewritten.insert(rewritten.end(), taken.begin(), taken.end());
+                continue;
+            }
+        }
+        rewritten.push_back(stmt);
+    }
+    body = std::move(rewritten);
+}
+
+void collect_used_names(NodePtr node, std::unordered_set<intern::Symbol>& used);
+
+void collect_used_in_body(const std::vector<NodePtr>& body, std::unordered_set<intern::Symbol>& used) {
+    for (const auto& stmt : body) {
+        collect_used_names(stmt, used);
+    }
+}
+
+void collect_used_names(NodePtr node, std::unordered_set<intern::Symbol>& used) {
+    switch (node->kind) {
+        case NodeKind::Name:
+            used.insert(static_cast<Name*>(node)->id);
+            break;
+        case NodeKind::Let:
+            collect_used_names(static_cast<Let*>(node)->value, used);
+            break;
+        case NodeKind::Assign: {
+            auto* assign = static_cast<Assign*>(node);
+            collect_used_names(assign->target, used);
+            collect_used_names(assign->value, used);
+            break;
+        }
+        case NodeKind::FunctionDef:
+            collect_used_in_body(static_cast<FunctionDef*>(node)->body, used);
+            break;
+        case NodeKind::ExportNames:
+            for (const auto& entry : static_cast<ExportNames*>(node)->names) {
+                used.insert(intern::intern(entry.first));
+            }
+            break;
+        case NodeKind::ExportDefault:
+            collect_used_names(static_cast<ExportDefault*>(node)->value, used);
+            break;
+        case NodeKind::Return: {
+            auto* ret = static_cast<Return*>(node);
+            if (ret->value) {
+                collect_used_names(*ret->value, used);
+            }
+            break;
+        }
+        case NodeKind::If: {
+            auto* branch = static_cast<If*>(node);
+            collect_used_names(branch->test, used);
+            collect_used_in_body(branch->body, used);
+            collect_used_in_body(branch->orelse, used);
+            break;
+        }
+        case NodeKind::While: {
+            auto* loop = static_cast<While*>(node);
+            collect_used_names(loop->test, used);
+            collect_used_in_body(loop->body, used);
+            break;
+        }
+        case NodeKind::For: {
+            auto* loop = static_cast<For*>(node);
+            collect_used_names(loop->iterator, used);
+            collect_used_in_body(loop->body, used);
+            break;
+        }
+        case NodeKind::Spawn:
+            collect_used_names(static_cast<Spawn*>(node)->call, used);
+            break;
+        case NodeKind::BinaryOp: {
+            auto* op = static_cast<BinaryOp*>(node);
+            collect_used_names(op->left, used);
+            collect_used_names(op->right, used);
+            break;
+        }
+        case NodeKind::UnaryOp:
+            collect_used_names(static_cast<UnaryOp*>(node)->operand, used);
+            break;
+        case NodeKind::Call: {
+            auto* call = static_cast<Call*>(node);
+            collect_used_names(call->func, used);
+            for (const auto& arg : call->args) {
+                collect_used_names(arg, used);
+            }
+            break;
+        }
+        case NodeKind::Attribute:
+            collect_used_names(static_cast<Attribute*>(node)->value, used);
+            break;
+        case NodeKind::ListLiteral:
+            for (const auto& element : static_cast<ListLiteral*>(node)->elements) {
+                collect_used_names(element, used);
+            }
+            break;
+        case NodeKind::DictLiteral:
+            for (const auto& [key, value] : static_cast<DictLiteral*>(node)->pairs) {
+                collect_used_names(key, used);
+                collect_used_names(value, used);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// True when evaluating the expression cannot observe or change program state.
+bool is_pure(const ExpressionPtr expr) {
+    switch (expr->kind) {
+        case NodeKind::Number:
+        case NodeKind::String:
+        case NodeKind::Boolean:
+        case NodeKind::Null:
+        case NodeKind::Name:
+            return true;
+        case NodeKind::BinaryOp: {
+            auto* op = static_cast<BinaryOp*>(expr);
+            return is_pure(op->left) && is_pure(op->right);
+        }
+        case NodeKind::UnaryOp:
+            return is_pure(static_cast<UnaryOp*>(expr)->operand);
+        case NodeKind::Attribute:
+            return is_pure(static_cast<Attribute*>(expr)->value);
+        case NodeKind::ListLiteral:
+            for (const auto& element : static_cast<ListLiteral*>(expr)->elements) {
+                if (!is_pure(element)) {
+                    return false;
+                }
+            }
+            return true;
+        case NodeKind::DictLiteral:
+            for (const auto& [key, value] : static_cast<DictLiteral*>(expr)->pairs) {
+                if (!is_pure(key) || !is_pure(value)) {
+                    return false;
+                }
+            }
+            return true;
+        default:
+            return false;  // calls and anything unknown may have effects
+    }
+}
+
+void remove_unused_lets(std::vector<NodePtr>& body, const std::unordered_set<intern::Symbol>& used) {
+    std::vector<NodePtr> kept;
+    kept.reserve(body.size());
+    for (const auto& stmt : body) {
+        if (stmt->kind == NodeKind::Let) {
+            auto* let = static_cast<Let*>(stmt);
+            if (!let->exported && !let->is_default && !used.contains(let->name) &&
+                is_pure(let->value)) {
+                continue;
+            }
+        } else if (stmt->kind == NodeKind::FunctionDef) {
+            remove_unused_lets(static_cast<FunctionDef*>(stmt)->body, used);
+        } else if (stmt->kind == NodeKind::If) {
+            auto* branch = static_cast<If*>(stmt);
+            remove_unused_lets(branch->body, used);
+            remove_unused_lets(branch->orelse, used);
+        } else if (stmt->kind == NodeKind::While) {
+            remove_unused_lets(static_cast<While*>(stmt)->body, used);
+        } else if (stmt->kind == NodeKind::For) {
+            remove_unused_lets(static_cast<For*>(stmt)->body, used);
+        }
+        kept.push_back(stmt);
+    }
+    body = std::move(kept);
+}
+
+}  // namespace
+
+void optimize(ast::ModulePtr module, ast::Arena& arena) {
+    run_on_body(module->body, arena);
+    // Name uses are collected after folding so lets referenced only by
+    // now-dead branches can be dropped too.
+    std::unordered_set<intern::Symbol> used;
+    collect_used_in_body(module->body, used);
+    remove_unused_lets(module->body, used);
+}
+
+}  // namespace trif::opt
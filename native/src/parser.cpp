@@ -1,5 +1,7 @@
 #include "trif/parser.hpp"
 
+#include "trif/source.hpp"
+
 #include <optional>
 #include <stdexcept>
 #include <string>
@@ -8,153 +10,201 @@
 namespace trif::parser {
 
 using lexer::Token;
+using lexer::TokenKind;
 using lexer::TokenStream;
 using namespace trif::ast;
 
 namespace {
 
+// Unwinds out of one malformed statement. Caught at statement boundaries when
+// recovering; surfaced as-is in fail-fast mode.
+struct ParseError : std::runtime_error {
+    ParseError(std::string message, source::LineColumn at)
+        : std::runtime_error(diagnostics::render({message, at.line, at.column})),
+          diagnostic{std::move(message), at.line, at.column} {}
+    diagnostics::Diagnostic diagnostic;
+};
+
 class Parser {
    public:
-    explicit Parser(const TokenStream& tokens) : tokens_(tokens) {}
+    Parser(std::string_view source, lexer::TokenCursor& cursor, Arena& arena,
+           diagnostics::DiagnosticList* diagnostics)
+        : sources_(source), cursor_(cursor), arena_(arena), diagnostics_(diagnostics) {}
 
     ModulePtr parse() {
-        auto module = make_module();
-        while (current().type != "EOF") {
-            if (current().type == "NEWLINE" || current().type == "SEMICOLON") {
+        auto module = make_module(arena_);
+        while (current().kind != TokenKind::Eof) {
+            if (current().kind == TokenKind::Newline || current().kind == TokenKind::Semicolon) {
                 consume();
                 continue;
             }
-            module->body.push_back(parse_statement());
+            std::size_t span_begin = current().offset;
+            if (!diagnostics_) {
+                module->body.push_back(parse_statement());
+                module->body_spans.push_back({span_begin, current().offset});
+                continue;
+            }
+            std::size_t start = cursor_.position();
+            try {
+                module->body.push_back(parse_statement());
+                module->body_spans.push_back({span_begin, current().offset});
+            } catch (const ParseError& error) {
+                diagnostics_->push_back(error.diagnostic);
+                synchronize();
+                if (cursor_.position() == start) {
+                    consume();  // stray boundary token; skip it so we make progress
+                }
+            }
         }
         return module;
     }
 
    private:
-    const TokenStream& tokens_;
-    std::size_t index_ = 0;
+    source::SourceManager sources_;
+    lexer::TokenCursor& cursor_;
+    Arena& arena_;
+    diagnostics::DiagnosticList* diagnostics_;
+
+    // Skips ahead to the next statement boundary after a recorded error.
+    void synchronize() {
+        while (current().kind != TokenKind::Newline && current().kind != TokenKind::Semicolon &&
+               current().kind != TokenKind::Rbrace && current().kind != TokenKind::Eof) {
+            consume();
+        }
+        while (match(TokenKind::Newline) || match(TokenKind::Semicolon)) {
+        }
+    }
+
+    [[noreturn]] void error(std::string message) const {
+        throw ParseError(std::move(message), sources_.position(current().offset));
+    }
+
+    const Token& current() const { return cursor_.current(); }
 
-    const Token& current() const { return tokens_[index_]; }
+    const Token& peek() const { return cursor_.peek(); }
 
-    const Token& peek(int offset = 1) const { return tokens_[index_ + offset]; }
+    const Token& consume() { return cursor_.consume(); }
 
-    const Token& consume(const std::string& expected = {}) {
+    const Token& consume(TokenKind expected) {
         const Token& token = current();
-        if (!expected.empty() && token.type != expected) {
-            throw std::runtime_error("Expected " + expected + " but got " + token.type + " at line " +
-                                     std::to_string(token.line));
+        if (token.kind != expected) {
+            throw ParseError(std::string("Expected ") + lexer::token_kind_name(expected) +
+                                 " but got " + lexer::token_kind_name(token.kind),
+                             sources_.position(token.offset));
         }
-        ++index_;
-        return token;
+        return cursor_.consume();
     }
 
-    bool match(std::initializer_list<std::string> types) {
-        for (const auto& type : types) {
-            if (current().type == type) {
-                ++index_;
+    bool match(std::initializer_list<TokenKind> kinds) {
+        for (TokenKind kind : kinds) {
+            if (current().kind == kind) {
+                cursor_.consume();
                 return true;
             }
         }
         return false;
     }
 
-    bool match(const std::string& type) {
-        if (current().type == type) {
-            ++index_;
+    bool match(TokenKind kind) {
+        if (current().kind == kind) {
+            cursor_.consume();
             return true;
         }
         return false;
     }
 
+    bool at_op(std::string_view op) const {
+        return current().kind == TokenKind::Op && current().value == op;
+    }
+
     std::string parse_dotted_name() {
-        std::string name = consume("NAME").value;
-        std::string result = name;
-        while (current().type == "DOT") {
-            consume("DOT");
-            result += "." + consume("NAME").value;
+        std::string result(consume(TokenKind::Name).value);
+        while (current().kind == TokenKind::Dot) {
+            consume(TokenKind::Dot);
+            result += ".";
+            result += consume(TokenKind::Name).value;
         }
         return result;
     }
 
     NodePtr parse_statement() {
         const auto& tok = current();
-        if (tok.type == "IMPORT") {
+        if (tok.kind == TokenKind::Import) {
             auto stmt = parse_import_statement();
             optional_newline();
             return stmt;
         }
-        if (tok.type == "EXPORT") {
+        if (tok.kind == TokenKind::Export) {
             auto stmt = parse_export_statement();
             optional_newline();
             return stmt;
         }
-        if (tok.type == "LET" || tok.type == "CONST") {
-            bool is_mutable = tok.type == "LET";
+        if (tok.kind == TokenKind::Let || tok.kind == TokenKind::Const) {
+            bool is_mutable = tok.kind == TokenKind::Let;
             consume();
             auto stmt = parse_variable_statement(is_mutable, false, false);
             optional_newline();
             return stmt;
         }
-        if (tok.type == "FN" || tok.type == "FUNCTION") {
+        if (tok.kind == TokenKind::Fn || tok.kind == TokenKind::Function) {
             auto stmt = parse_function_statement(false, false);
             optional_newline();
             return stmt;
         }
-        if (tok.type == "RETURN") {
+        if (tok.kind == TokenKind::Return) {
             consume();
-            auto node = std::make_shared<Return>();
-            if (current().type != "NEWLINE" && current().type != "RBRACE" && current().type != "EOF") {
-                node->value = parse_expression();
+            std::optional<ExpressionPtr> value;
+            if (current().kind != TokenKind::Newline && current().kind != TokenKind::Rbrace &&
+                current().kind != TokenKind::Eof) {
+                value = parse_expression();
             }
+            auto node = arena_.create<Return>(value);
             optional_newline();
             return node;
         }
-        if (tok.type == "IF") {
+        if (tok.kind == TokenKind::If) {
             consume();
-            auto node = std::make_shared<If>();
-            node->test = parse_expression();
-            node->body = parse_block();
-            if (match("ELSE")) {
-                node->orelse = parse_block();
+            auto test = parse_expression();
+            auto body = parse_block();
+            std::vector<NodePtr> orelse;
+            if (match(TokenKind::Else)) {
+                orelse = parse_block();
             }
+            auto node = arena_.create<If>(test, std::move(body), std::move(orelse));
             optional_newline();
             return node;
         }
-        if (tok.type == "WHILE") {
+        if (tok.kind == TokenKind::While) {
             consume();
-            auto node = std::make_shared<While>();
-            node->test = parse_expression();
-            node->body = parse_block();
+            auto test = parse_expression();
+            auto node = arena_.create<While>(test, parse_block());
             optional_newline();
             return node;
         }
-        if (tok.type == "FOR") {
+        if (tok.kind == TokenKind::For) {
             consume();
-            auto node = std::make_shared<For>();
-            node->target = consume("NAME").value;
-            consume("IN");
-            node->iterator = parse_expression();
-            node->body = parse_block();
+            intern::Symbol target = intern::intern(consume(TokenKind::Name).value);
+            consume(TokenKind::In);
+            auto iterator = parse_expression();
+            auto node = arena_.create<For>(target, iterator, parse_block());
             optional_newline();
             return node;
         }
-        if (tok.type == "SPAWN") {
+        if (tok.kind == TokenKind::Spawn) {
             consume();
             auto call_expr = parse_expression();
             if (call_expr->kind != NodeKind::Call) {
-                throw std::runtime_error("spawn expects a function call");
+                error("spawn expects a function call");
             }
-            auto node = std::make_shared<Spawn>();
-            node->call = std::static_pointer_cast<Expression>(call_expr);
+            auto node = arena_.create<Spawn>(static_cast<Expression*>(call_expr));
             optional_newline();
             return node;
         }
         auto expr = parse_expression();
         if (expr->kind == NodeKind::Name || expr->kind == NodeKind::Attribute) {
-            if (current().type == "OP" && current().value == "=") {
-                consume("OP");
-                auto assign = std::make_shared<Assign>();
-                assign->target = expr;
-                assign->value = parse_expression();
+            if (at_op("=")) {
+                consume(TokenKind::Op);
+                auto assign = arena_.create<Assign>(expr, parse_expression());
                 optional_newline();
                 return assign;
             }
@@ -164,45 +214,45 @@ class Parser {
     }
 
     NodePtr parse_import_statement() {
-        consume("IMPORT");
+        consume(TokenKind::Import);
         std::optional<std::string> default_target;
         std::vector<std::pair<std::string, std::string>> names;
         std::optional<std::string> namespace_name;
 
-        if (current().type == "STRING") {
-            std::string module_name = consume("STRING").value;
+        if (current().kind == TokenKind::String) {
+            std::string module_name = lexer::decode_string_literal(consume(TokenKind::String).value);
             std::optional<std::string> alias;
-            if (match("AS")) {
-                alias = consume("NAME").value;
+            if (match(TokenKind::As)) {
+                alias = std::string(consume(TokenKind::Name).value);
             }
-            auto node = std::make_shared<Import>();
+            auto node = arena_.create<Import>();
             node->module = module_name;
             node->alias = alias;
             return node;
         }
 
-        if (current().type == "NAME" && peek().type == "COMMA") {
-            default_target = consume("NAME").value;
-            consume("COMMA");
-            if (current().type == "LBRACE") {
+        if (current().kind == TokenKind::Name && peek().kind == TokenKind::Comma) {
+            default_target = std::string(consume(TokenKind::Name).value);
+            consume(TokenKind::Comma);
+            if (current().kind == TokenKind::Lbrace) {
                 names = parse_import_specifiers();
             } else {
-                throw std::runtime_error("Expected named import list after comma");
+                error("Expected named import list after comma");
             }
-        } else if (current().type == "NAME" && peek().type == "FROM") {
-            default_target = consume("NAME").value;
-        } else if (current().type == "LBRACE") {
+        } else if (current().kind == TokenKind::Name && peek().kind == TokenKind::From) {
+            default_target = std::string(consume(TokenKind::Name).value);
+        } else if (current().kind == TokenKind::Lbrace) {
             names = parse_import_specifiers();
-        } else if (current().type == "OP" && current().value == "*") {
-            consume("OP");
-            consume("AS");
-            namespace_name = consume("NAME").value;
+        } else if (at_op("*")) {
+            consume(TokenKind::Op);
+            consume(TokenKind::As);
+            namespace_name = std::string(consume(TokenKind::Name).value);
         }
 
         if (default_target || !names.empty() || namespace_name) {
-            consume("FROM");
+            consume(TokenKind::From);
             std::string module_name = parse_module_specifier();
-            auto node = std::make_shared<ImportFrom>();
+            auto node = arena_.create<ImportFrom>();
             node->module = module_name;
             node->names = names;
             node->default_name = default_target;
@@ -212,241 +262,208 @@ class Parser {
 
         std::string module_name = parse_module_specifier();
         std::optional<std::string> alias;
-        if (match("AS")) {
-            alias = consume("NAME").value;
+        if (match(TokenKind::As)) {
+            alias = std::string(consume(TokenKind::Name).value);
         }
-        auto node = std::make_shared<Import>();
+        auto node = arena_.create<Import>();
         node->module = module_name;
         node->alias = alias;
         return node;
     }
 
     NodePtr parse_export_statement() {
-        consume("EXPORT");
-        if (current().type == "DEFAULT") {
-            consume("DEFAULT");
-            if (current().type == "FN" || current().type == "FUNCTION") {
+        consume(TokenKind::Export);
+        if (current().kind == TokenKind::Default) {
+            consume(TokenKind::Default);
+            if (current().kind == TokenKind::Fn || current().kind == TokenKind::Function) {
                 return parse_function_statement(true, true);
             }
-            if (current().type == "LET" || current().type == "CONST") {
-                bool mut = current().type == "LET";
+            if (current().kind == TokenKind::Let || current().kind == TokenKind::Const) {
+                bool mut = current().kind == TokenKind::Let;
                 consume();
                 return parse_variable_statement(mut, true, true);
             }
-            auto node = std::make_shared<ExportDefault>();
+            auto node = arena_.create<ExportDefault>();
             node->value = parse_expression();
             return node;
         }
-        if (current().type == "FN" || current().type == "FUNCTION") {
+        if (current().kind == TokenKind::Fn || current().kind == TokenKind::Function) {
             return parse_function_statement(true, false);
         }
-        if (current().type == "LET" || current().type == "CONST") {
-            bool mut = current().type == "LET";
+        if (current().kind == TokenKind::Let || current().kind == TokenKind::Const) {
+            bool mut = current().kind == TokenKind::Let;
             consume();
             return parse_variable_statement(mut, true, false);
         }
-        if (current().type == "LBRACE") {
-            auto node = std::make_shared<ExportNames>();
+        if (current().kind == TokenKind::Lbrace) {
+            auto node = arena_.create<ExportNames>();
             node->names = parse_export_specifiers();
-            if (match("FROM")) {
+            if (match(TokenKind::From)) {
                 node->source = parse_module_specifier();
             }
             return node;
         }
-        throw std::runtime_error("Unsupported export statement");
+        error("Unsupported export statement");
     }
 
     std::vector<std::pair<std::string, std::string>> parse_import_specifiers() {
-        consume("LBRACE");
+        consume(TokenKind::Lbrace);
         std::vector<std::pair<std::string, std::string>> names;
-        while (current().type != "RBRACE") {
-            std::string imported = consume("NAME").value;
+        while (current().kind != TokenKind::Rbrace) {
+            std::string imported(consume(TokenKind::Name).value);
             std::string alias = imported;
-            if (match("AS")) {
-                alias = consume("NAME").value;
+            if (match(TokenKind::As)) {
+                alias = std::string(consume(TokenKind::Name).value);
             }
             names.emplace_back(imported, alias);
-            if (!match("COMMA")) {
+            if (!match(TokenKind::Comma)) {
                 break;
             }
         }
-        consume("RBRACE");
+        consume(TokenKind::Rbrace);
         return names;
     }
 
     std::vector<std::pair<std::string, std::string>> parse_export_specifiers() {
-        consume("LBRACE");
+        consume(TokenKind::Lbrace);
         std::vector<std::pair<std::string, std::string>> names;
-        while (current().type != "RBRACE") {
-            std::string local = consume("NAME").value;
+        while (current().kind != TokenKind::Rbrace) {
+            std::string local(consume(TokenKind::Name).value);
             std::string exported = local;
-            if (match("AS")) {
-                exported = consume("NAME").value;
+            if (match(TokenKind::As)) {
+                exported = std::string(consume(TokenKind::Name).value);
             }
             names.emplace_back(local, exported);
-            if (!match("COMMA")) {
+            if (!match(TokenKind::Comma)) {
                 break;
             }
         }
-        consume("RBRACE");
+        consume(TokenKind::Rbrace);
         return names;
     }
 
     std::string parse_module_specifier() {
-        if (current().type == "STRING") {
-            return consume("STRING").value;
+        if (current().kind == TokenKind::String) {
+            return lexer::decode_string_literal(consume(TokenKind::String).value);
         }
         return parse_dotted_name();
     }
 
     NodePtr parse_variable_statement(bool mutable_flag, bool exported, bool is_default) {
-        std::string name = consume("NAME").value;
-        if (current().type != "OP" || current().value != "=") {
-            throw std::runtime_error("Expected '=' in variable declaration");
-        }
-        consume("OP");
-        auto let = std::make_shared<Let>();
-        let->name = name;
-        let->value = parse_expression();
-        let->mutable_flag = mutable_flag;
-        let->exported = exported;
-        let->is_default = is_default;
-        return let;
+        intern::Symbol name = intern::intern(consume(TokenKind::Name).value);
+        if (!at_op("=")) {
+            error("Expected '=' in variable declaration");
+        }
+        consume(TokenKind::Op);
+        return arena_.create<Let>(name, parse_expression(), mutable_flag, exported, is_default);
     }
 
     NodePtr parse_function_statement(bool exported, bool is_default) {
         consume();
-        std::string name;
-        if (current().type == "NAME") {
-            name = consume("NAME").value;
+        intern::Symbol name;
+        if (current().kind == TokenKind::Name) {
+            name = intern::intern(consume(TokenKind::Name).value);
         } else if (is_default) {
-            name = "_default_export";
+            name = intern::intern("_default_export");
         } else {
-            throw std::runtime_error("Function declaration requires a name");
+            error("Function declaration requires a name");
         }
-        consume("LPAREN");
-        std::vector<std::string> params;
-        if (current().type != "RPAREN") {
+        consume(TokenKind::Lparen);
+        std::vector<intern::Symbol> params;
+        if (current().kind != TokenKind::Rparen) {
             while (true) {
-                params.push_back(consume("NAME").value);
-                if (!match("COMMA")) {
+                params.push_back(intern::intern(consume(TokenKind::Name).value));
+                if (!match(TokenKind::Comma)) {
                     break;
                 }
             }
         }
-        consume("RPAREN");
-        auto node = std::make_shared<FunctionDef>();
-        node->name = name;
-        node->params = params;
-        node->body = parse_block();
-        node->exported = exported;
-        node->is_default = is_default;
-        return node;
+        consume(TokenKind::Rparen);
+        return arena_.create<FunctionDef>(name, std::move(params), parse_block(), exported,
+                                          is_default);
     }
 
     void optional_newline() {
-        while (current().type == "NEWLINE" || current().type == "SEMICOLON") {
+        while (current().kind == TokenKind::Newline || current().kind == TokenKind::Semicolon) {
             consume();
         }
     }
 
     std::vector<NodePtr> parse_block() {
-        consume("LBRACE");
+        consume(TokenKind::Lbrace);
         std::vector<NodePtr> body;
-        while (current().type != "RBRACE") {
-            if (current().type == "NEWLINE" || current().type == "SEMICOLON") {
+        while (current().kind != TokenKind::Rbrace && current().kind != TokenKind::Eof) {
+            if (current().kind == TokenKind::Newline || current().kind == TokenKind::Semicolon) {
                 consume();
                 continue;
             }
-            body.push_back(parse_statement());
+            if (!diagnostics_) {
+                body.push_back(parse_statement());
+                continue;
+            }
+            std::size_t start = cursor_.position();
+            try {
+                body.push_back(parse_statement());
+            } catch (const ParseError& error) {
+                diagnostics_->push_back(error.diagnostic);
+                synchronize();
+                if (cursor_.position() == start && current().kind != TokenKind::Rbrace &&
+                    current().kind != TokenKind::Eof) {
+                    consume();
+                }
+            }
         }
-        consume("RBRACE");
+        consume(TokenKind::Rbrace);
         return body;
     }
 
-    ExpressionPtr parse_expression() { return parse_or(); }
+    ExpressionPtr parse_expression() { return parse_binary(1); }
 
-    ExpressionPtr parse_or() {
-        auto expr = parse_and();
-        while (current().type == "OP" && current().value == "||") {
-            auto node = std::make_shared<BinaryOp>();
-            node->left = expr;
-            node->op = consume("OP").value;
-            node->right = parse_and();
-            expr = node;
+    // Left binding power per binary operator; higher binds tighter and zero
+    // stops the climb (so '=' and '=>' never start a binary expression).
+    static int binding_power(std::string_view op) {
+        if (op == "||") {
+            return 1;
         }
-        return expr;
-    }
-
-    ExpressionPtr parse_and() {
-        auto expr = parse_equality();
-        while (current().type == "OP" && current().value == "&&") {
-            auto node = std::make_shared<BinaryOp>();
-            node->left = expr;
-            node->op = consume("OP").value;
-            node->right = parse_equality();
-            expr = node;
+        if (op == "&&") {
+            return 2;
         }
-        return expr;
-    }
-
-    ExpressionPtr parse_equality() {
-        auto expr = parse_comparison();
-        while (current().type == "OP" && (current().value == "==" || current().value == "!=")) {
-            auto node = std::make_shared<BinaryOp>();
-            node->left = expr;
-            node->op = consume("OP").value;
-            node->right = parse_comparison();
-            expr = node;
+        if (op == "==" || op == "!=") {
+            return 3;
         }
-        return expr;
-    }
-
-    ExpressionPtr parse_comparison() {
-        auto expr = parse_term();
-        while (current().type == "OP" &&
-               (current().value == "<" || current().value == ">" || current().value == "<=" ||
-                current().value == ">=")) {
-            auto node = std::make_shared<BinaryOp>();
-            node->left = expr;
-            node->op = consume("OP").value;
-            node->right = parse_term();
-            expr = node;
+        if (op == "<" || op == ">" || op == "<=" || op == ">=") {
+            return 4;
         }
-        return expr;
-    }
-
-    ExpressionPtr parse_term() {
-        auto expr = parse_factor();
-        while (current().type == "OP" && (current().value == "+" || current().value == "-")) {
-            auto node = std::make_shared<BinaryOp>();
-            node->left = expr;
-            node->op = consume("OP").value;
-            node->right = parse_factor();
-            expr = node;
+        if (op == "+" || op == "-") {
+            return 5;
         }
-        return expr;
+        if (op == "*" || op == "/" || op == "%") {
+            return 6;
+        }
+        return 0;
     }
 
-    ExpressionPtr parse_factor() {
+    // Precedence climbing over the table above, replacing one recursive
+    // method per tier: a bare literal costs a single call instead of the
+    // whole ladder. Every operator is left-associative, so the recursive
+    // climb asks for strictly tighter binding on the right.
+    ExpressionPtr parse_binary(int min_power) {
         auto expr = parse_unary();
-        while (current().type == "OP" &&
-               (current().value == "*" || current().value == "/" || current().value == "%")) {
-            auto node = std::make_shared<BinaryOp>();
-            node->left = expr;
-            node->op = consume("OP").value;
-            node->right = parse_unary();
-            expr = node;
+        while (current().kind == TokenKind::Op) {
+            int power = binding_power(current().value);
+            if (power < min_power) {
+                break;
+            }
+            std::string op(consume().value);
+            expr = arena_.create<BinaryOp>(expr, std::move(op), parse_binary(power + 1));
         }
         return expr;
     }
 
     ExpressionPtr parse_unary() {
-        if (current().type == "OP" && (current().value == "-" || current().value == "!")) {
-            auto node = std::make_shared<UnaryOp>();
-            node->op = consume("OP").value;
-            node->operand = parse_unary();
-            return node;
+        if (at_op("-") || at_op("!")) {
+            std::string op(consume(TokenKind::Op).value);
+            return arena_.create<UnaryOp>(std::move(op), parse_unary());
         }
         return parse_call_expression();
     }
@@ -454,24 +471,20 @@ class Parser {
     ExpressionPtr parse_call_expression() {
         auto expr = parse_primary();
         while (true) {
-            if (match("LPAREN")) {
-                auto call = std::make_shared<Call>();
-                call->func = expr;
-                if (current().type != "RPAREN") {
+            if (match(TokenKind::Lparen)) {
+                std::vector<ExpressionPtr> args;
+                if (current().kind != TokenKind::Rparen) {
                     while (true) {
-                        call->args.push_back(parse_expression());
-                        if (!match("COMMA")) {
+                        args.push_back(parse_expression());
+                        if (!match(TokenKind::Comma)) {
                             break;
                         }
                     }
                 }
-                consume("RPAREN");
-                expr = call;
-            } else if (match("DOT")) {
-                auto attr = std::make_shared<Attribute>();
-                attr->value = expr;
-                attr->attr = consume("NAME").value;
-                expr = attr;
+                consume(TokenKind::Rparen);
+                expr = arena_.create<Call>(expr, std::move(args));
+            } else if (match(TokenKind::Dot)) {
+                expr = arena_.create<Attribute>(expr, intern::intern(consume(TokenKind::Name).value));
             } else {
                 break;
             }
@@ -480,86 +493,97 @@ class Parser {
     }
 
     ExpressionPtr parse_primary() {
-        const auto& tok = current();
-        if (tok.type == "NUMBER") {
+        // By value: the cursor window moves underneath us on consume().
+        const Token tok = current();
+        if (tok.kind == TokenKind::Number) {
             consume();
-            auto node = std::make_shared<Number>();
-            node->value = std::stod(tok.value);
-            return node;
+            return arena_.create<Number>(std::stod(std::string(tok.value)));
         }
-        if (tok.type == "STRING") {
+        if (tok.kind == TokenKind::String) {
             consume();
-            auto node = std::make_shared<String>();
-            node->value = tok.value;
-            return node;
+            return arena_.create<String>(lexer::decode_string_literal(tok.value));
         }
-        if (tok.type == "TRUE") {
+        if (tok.kind == TokenKind::True) {
             consume();
-            auto node = std::make_shared<Boolean>();
-            node->value = true;
-            return node;
+            return arena_.create<Boolean>(true);
         }
-        if (tok.type == "FALSE") {
+        if (tok.kind == TokenKind::False) {
             consume();
-            auto node = std::make_shared<Boolean>();
-            node->value = false;
-            return node;
+            return arena_.create<Boolean>(false);
         }
-        if (tok.type == "NULL") {
+        if (tok.kind == TokenKind::Null) {
             consume();
-            return std::make_shared<Null>();
+            return arena_.create<Null>();
         }
-        if (tok.type == "NAME") {
+        if (tok.kind == TokenKind::Name) {
             consume();
-            auto node = std::make_shared<Name>();
-            node->id = tok.value;
-            return node;
+            return arena_.create<Name>(intern::intern(tok.value));
         }
-        if (tok.type == "LPAREN") {
+        if (tok.kind == TokenKind::Lparen) {
             consume();
             auto expr = parse_expression();
-            consume("RPAREN");
+            consume(TokenKind::Rparen);
             return expr;
         }
-        if (tok.type == "LBRACKET") {
+        if (tok.kind == TokenKind::Lbracket) {
             consume();
-            auto node = std::make_shared<ListLiteral>();
-            if (current().type != "RBRACKET") {
+            std::vector<ExpressionPtr> elements;
+            if (current().kind != TokenKind::Rbracket) {
                 while (true) {
-                    node->elements.push_back(parse_expression());
-                    if (!match("COMMA")) {
+                    elements.push_back(parse_expression());
+                    if (!match(TokenKind::Comma)) {
                         break;
                     }
                 }
             }
-            consume("RBRACKET");
-            return node;
+            consume(TokenKind::Rbracket);
+            return arena_.create<ListLiteral>(std::move(elements));
         }
-        if (tok.type == "LBRACE") {
+        if (tok.kind == TokenKind::Lbrace) {
             consume();
-            auto node = std::make_shared<DictLiteral>();
-            if (current().type != "RBRACE") {
+            std::vector<std::pair<ExpressionPtr, ExpressionPtr>> pairs;
+            if (current().kind != TokenKind::Rbrace) {
                 while (true) {
                     auto key = parse_expression();
-                    consume("COLON");
+                    consume(TokenKind::Colon);
                     auto value = parse_expression();
-                    node->pairs.emplace_back(key, value);
-                    if (!match("COMMA")) {
+                    pairs.emplace_back(key, value);
+                    if (!match(TokenKind::Comma)) {
                         break;
                     }
                 }
             }
-            consume("RBRACE");
-            return node;
+            consume(TokenKind::Rbrace);
+            return arena_.create<DictLiteral>(std::move(pairs));
         }
-        throw std::runtime_error("Unexpected token " + tok.type + " at line " + std::to_string(tok.line));
+        throw ParseError(std::string("Unexpected token ") + lexer::token_kind_name(tok.kind),
+                         sources_.position(tok.offset));
     }
 };
 
 }  // namespace
 
-ModulePtr parse(const TokenStream& tokens) {
-    Parser parser(tokens);
+ModulePtr parse(std::string_view source, const TokenStream& tokens, ast::Arena& arena) {
+    lexer::TokenCursor cursor(tokens);
+    Parser parser(source, cursor, arena, nullptr);
+    return parser.parse();
+}
+
+ModulePtr parse(std::string_view source, const TokenStream& tokens, ast::Arena& arena,
+                diagnostics::DiagnosticList& diagnostics) {
+    lexer::TokenCursor cursor(tokens);
+    Parser parser(source, cursor, arena, &diagnostics);
+    return parser.parse();
+}
+
+ModulePtr parse(std::string_view source, lexer::TokenCursor& cursor, ast::Arena& arena) {
+    Parser parser(source, cursor, arena, nullptr);
+    return parser.parse();
+}
+
+ModulePtr parse(std::string_view source, lexer::TokenCursor& cursor, ast::Arena& arena,
+                diagnostics::DiagnosticList& diagnostics) {
+    Parser parser(source, cursor, arena, &diagnostics);
     return parser.parse();
 }
 
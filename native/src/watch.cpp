@@ -0,0 +1,199 @@
+#include "trif/watch.hpp"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "trif/codegen.hpp"
+#include "trif/diagnostics.hpp"
+#include "trif/lexer.hpp"
+#include "trif/parser.hpp"
+
+namespace trif::watch {
+
+namespace {
+
+// Resident state for one watched module. Every arena that ever contributed
+// statements to the current module is retained for the session; that slow
+// growth is the price of edit-sized re-parses.
+struct Session {
+    std::string source;
+    std::vector<std::unique_ptr<ast::Arena>> arenas;
+    ast::ModulePtr module = nullptr;
+};
+
+std::optional<std::string> read_file(const std::string& path) {
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        return std::nullopt;
+    }
+    std::ostringstream buffer;
+    buffer << stream.rdbuf();
+    return buffer.str();
+}
+
+// Parses `source` from scratch, replacing all resident state on success.
+bool full_compile(Session& session, std::string source,
+                  diagnostics::DiagnosticList& diagnostics) {
+    auto arena = std::make_unique<ast::Arena>();
+    lexer::TokenCursor cursor(source, &diagnostics);
+    auto module = parser::parse(source, cursor, *arena, diagnostics);
+    if (!diagnostics.empty()) {
+        return false;
+    }
+    session.arenas.clear();
+    session.arenas.push_back(std::move(arena));
+    session.module = module;
+    session.source = std::move(source);
+    return true;
+}
+
+// Maps the edit between the resident source and `next_source` onto the
+// module's statement spans, re-parses just that region, and splices the new
+// declarations into the body. Returns the number of re-parsed statements, or
+// nullopt when the change cannot be mapped (caller does a full parse).
+std::optional<std::size_t> incremental_update(Session& session, const std::string& next_source) {
+    const std::string& old_source = session.source;
+    const auto& spans = session.module->body_spans;
+    if (spans.empty() || spans.size() != session.module->body.size()) {
+        return std::nullopt;
+    }
+    const std::size_t old_size = old_source.size();
+    const std::size_t new_size = next_source.size();
+    const std::size_t limit = std::min(old_size, new_size);
+    std::size_t prefix = 0;
+    while (prefix < limit && old_source[prefix] == next_source[prefix]) {
+        ++prefix;
+    }
+    std::size_t suffix = 0;
+    while (suffix < limit - prefix &&
+           old_source[old_size - 1 - suffix] == next_source[new_size - 1 - suffix]) {
+        ++suffix;
+    }
+    const std::size_t old_changed_end = old_size - suffix;
+
+    // First and last statements whose spans intersect the changed range;
+    // edits in leading or trailing trivia are pulled into the nearest one.
+    std::size_t first = 0;
+    while (first + 1 < spans.size() && spans[first].end <= prefix) {
+        ++first;
+    }
+    std::size_t last = spans.size() - 1;
+    while (last > first && spans[last].begin >= old_changed_end) {
+        --last;
+    }
+    const std::size_t region_begin = std::min(spans[first].begin, prefix);
+    const std::size_t old_region_end = std::max(spans[last].end, old_changed_end);
+    const std::size_t new_region_end = old_region_end + new_size - old_size;
+    if (new_region_end > new_size || region_begin > new_region_end) {
+        return std::nullopt;
+    }
+
+    std::string_view fragment(next_source.data() + region_begin, new_region_end - region_begin);
+    diagnostics::DiagnosticList diagnostics;
+    auto arena = std::make_unique<ast::Arena>();
+    lexer::TokenCursor cursor(fragment, &diagnostics);
+    auto parsed = parser::parse(fragment, cursor, *arena, diagnostics);
+    if (!diagnostics.empty()) {
+        return std::nullopt;  // the fragment may lean on surrounding text
+    }
+
+    auto merged = ast::make_module(*arena);
+    const auto& body = session.module->body;
+    merged->body.reserve(first + parsed->body.size() + (body.size() - last - 1));
+    merged->body_spans.reserve(merged->body.capacity());
+    for (std::size_t i = 0; i < first; ++i) {
+        merged->body.push_back(body[i]);
+        merged->body_spans.push_back(spans[i]);
+    }
+    for (std::size_t i = 0; i < parsed->body.size(); ++i) {
+        merged->body.push_back(parsed->body[i]);
+        merged->body_spans.push_back({parsed->body_spans[i].begin + region_begin,
+                                      parsed->body_spans[i].end + region_begin});
+    }
+    for (std::size_t i = last + 1; i < body.size(); ++i) {
+        merged->body.push_back(body[i]);
+        merged->body_spans.push_back({spans[i].begin + new_size - old_size,
+                                      spans[i].end + new_size - old_size});
+    }
+    session.module = merged;
+    session.arenas.push_back(std::move(arena));
+    session.source = next_source;
+    return parsed->body.size();
+}
+
+}  // namespace
+
+int serve(const std::string& input, const std::string& output_path,
+          const compiler::CompileOptions& options) {
+    auto generator = codegen::create_generator(options.target);
+    if (!generator) {
+        std::cerr << "trifc: Unknown target: " << options.target << std::endl;
+        return 1;
+    }
+    Session session;
+    auto rebuild = [&](bool initial) {
+        auto contents = read_file(input);
+        if (!contents) {
+            std::cerr << "trifc: Unable to open file: " << input << std::endl;
+            return;
+        }
+        if (!initial && *contents == session.source) {
+            return;  // touched but unchanged
+        }
+        std::size_t reparsed = 0;
+        bool spliced = false;
+        if (!initial && session.module) {
+            if (auto count = incremental_update(session, *contents)) {
+                reparsed = *count;
+                spliced = true;
+            }
+        }
+        if (!spliced) {
+            diagnostics::DiagnosticList diagnostics;
+            if (!full_compile(session, std::move(*contents), diagnostics)) {
+                for (const auto& diagnostic : diagnostics) {
+                    std::cerr << "trifc: " << input << ": " << diagnostics::render(diagnostic)
+                              << std::endl;
+                }
+                return;
+            }
+            reparsed = session.module->body.size();
+        }
+        std::ofstream stream(output_path);
+        if (!stream) {
+            std::cerr << "trifc: Unable to write to output path: " << output_path << std::endl;
+            return;
+        }
+        generator->generate_to(session.module, stream);
+        std::cerr << "trifc: " << input << " -> " << output_path << " (" << reparsed << "/"
+                  << session.module->body.size() << " declarations reparsed)" << std::endl;
+    };
+    rebuild(true);
+    struct stat last{};
+    ::stat(input.c_str(), &last);
+    for (;;) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        struct stat info{};
+        if (::stat(input.c_str(), &info) != 0) {
+            continue;  // the editor may be mid-way through an atomic replace
+        }
+        if (info.st_mtim.tv_sec != last.st_mtim.tv_sec ||
+            info.st_mtim.tv_nsec != last.st_mtim.tv_nsec || info.st_size != last.st_size) {
+            last = info;
+            rebuild(false);
+        }
+    }
+}
+
+}  // namespace trif::watch
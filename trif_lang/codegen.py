@@ -80,7 +80,7 @@ class PythonGenerator(BaseGenerator):
         self.indent += 1
         self.emit("runtime.default_entry_point(locals())")
         self.indent -= 1
-        return "\n".join(self.lines)
+        return "\n".join(self.lines) + "\n"
 
     def visit(self, node):
         method = getattr(self, f"visit_{type(node).__name__}", None)
@@ -270,7 +270,7 @@ class JavaScriptGenerator(BaseGenerator):
         self.emit("runtime.registerModuleExports(__trifExports, __trifDefault);")
         if not any(isinstance(stmt, FunctionDef) and stmt.name == "main" for stmt in module.body):
             self.emit("runtime.defaultEntryPoint(globalThis);")
-        return "\n".join(self.lines)
+        return "\n".join(self.lines) + "\n"
 
     def visit(self, node):
         method = getattr(self, f"visit_{type(node).__name__}", None)
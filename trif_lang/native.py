@@ -0,0 +1,118 @@
+"""ctypes binding to the native compiler library (libtrifc).
+
+When ``native/build.sh libtrifc`` has produced ``libtrifc.so`` the toolchain
+compiles source buffers in-process through the C ABI declared in
+``native/include/trif/capi.h`` instead of the pure-Python pipeline, which
+avoids process spawn and pipe serialization per file. The binding is entirely
+optional: :func:`load` returns ``None`` when the library is absent and
+callers fall back to the Python compiler.
+"""
+from __future__ import annotations
+
+import ctypes
+import os
+from pathlib import Path
+from typing import List, Optional
+
+_SUPPORTED_TARGETS = {"python", "javascript"}
+
+
+class NativeCompileError(ValueError):
+    """Raised when the native compiler reports diagnostics for a buffer."""
+
+    def __init__(self, diagnostics: List[str]) -> None:
+        super().__init__("\n".join(diagnostics) or "native compile failed")
+        self.diagnostics = diagnostics
+
+
+class NativeCompiler:
+    """One libtrifc session; repeated compiles share its output cache."""
+
+    def __init__(self, library: ctypes.CDLL, cache_dir: Path | None = None) -> None:
+        self._lib = library
+        cache = str(cache_dir).encode("utf-8") if cache_dir is not None else None
+        self._session = self._lib.trifc_session_new(cache)
+        if not self._session:
+            raise OSError("trifc_session_new returned NULL")
+
+    def __del__(self) -> None:
+        session = getattr(self, "_session", None)
+        if session:
+            self._lib.trifc_session_free(session)
+            self._session = None
+
+    @staticmethod
+    def supports_target(target: str) -> bool:
+        return target in _SUPPORTED_TARGETS
+
+    def compile_source(self, source: str, target: str = "python", *, optimize: bool = True) -> str:
+        if target not in _SUPPORTED_TARGETS:
+            raise ValueError(f"Native compiler does not handle target '{target}'")
+        data = source.encode("utf-8")
+        result = self._lib.trifc_compile(
+            self._session, data, len(data), target.encode("ascii"), 1 if optimize else 0
+        )
+        if not result:
+            raise MemoryError("trifc_compile returned NULL")
+        try:
+            count = self._lib.trifc_result_diagnostic_count(result)
+            if count:
+                diagnostics = [
+                    self._lib.trifc_result_diagnostic(result, index).decode("utf-8")
+                    for index in range(count)
+                ]
+                raise NativeCompileError(diagnostics)
+            length = ctypes.c_size_t()
+            output = self._lib.trifc_result_output(result, ctypes.byref(length))
+            return ctypes.string_at(output, length.value).decode("utf-8")
+        finally:
+            self._lib.trifc_result_free(result)
+
+
+def _candidate_paths() -> List[Path]:
+    paths: List[Path] = []
+    override = os.environ.get("TRIF_NATIVE_LIB")
+    if override:
+        paths.append(Path(override))
+    paths.append(Path(__file__).resolve().parent.parent / "native" / "build" / "libtrifc.so")
+    return paths
+
+
+def _bind(library: ctypes.CDLL) -> ctypes.CDLL:
+    library.trifc_session_new.argtypes = [ctypes.c_char_p]
+    library.trifc_session_new.restype = ctypes.c_void_p
+    library.trifc_session_free.argtypes = [ctypes.c_void_p]
+    library.trifc_session_free.restype = None
+    library.trifc_compile.argtypes = [
+        ctypes.c_void_p,
+        ctypes.c_char_p,
+        ctypes.c_size_t,
+        ctypes.c_char_p,
+        ctypes.c_int,
+    ]
+    library.trifc_compile.restype = ctypes.c_void_p
+    library.trifc_result_output.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_size_t)]
+    library.trifc_result_output.restype = ctypes.c_void_p
+    library.trifc_result_diagnostic_count.argtypes = [ctypes.c_void_p]
+    library.trifc_result_diagnostic_count.restype = ctypes.c_size_t
+    library.trifc_result_diagnostic.argtypes = [ctypes.c_void_p, ctypes.c_size_t]
+    library.trifc_result_diagnostic.restype = ctypes.c_char_p
+    library.trifc_result_free.argtypes = [ctypes.c_void_p]
+    library.trifc_result_free.restype = None
+    return library
+
+
+def load(cache_dir: Path | None = None) -> Optional[NativeCompiler]:
+    """Return a :class:`NativeCompiler` when libtrifc.so is available."""
+
+    for path in _candidate_paths():
+        if not path.is_file():
+            continue
+        try:
+            return NativeCompiler(_bind(ctypes.CDLL(str(path))), cache_dir=cache_dir)
+        except OSError:
+            continue
+    return None
+
+
+__all__ = ["NativeCompileError", "NativeCompiler", "load"]
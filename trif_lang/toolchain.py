@@ -4,6 +4,7 @@ from dataclasses import dataclass, field
 from pathlib import Path
 from typing import Iterable, List, Sequence
 
+from . import native
 from .compiler import Compiler
 from .package_manager import PackageManager
 from .runtime import Runtime
@@ -40,6 +41,10 @@ class Toolchain:
     def __init__(self, project_root: Path | None = None) -> None:
         self.project_root = (project_root or Path.cwd()).resolve()
         self.compiler = Compiler()
+        # In-process native compiler (libtrifc via ctypes); None when the
+        # shared library has not been built, in which case text targets fall
+        # back to the pure-Python pipeline.
+        self.native_compiler = native.load()
         self.runtime = Runtime()
         self.package_manager = PackageManager(project_root=self.project_root)
         self.runtime.prepare_project_environment(self.project_root)
@@ -72,15 +77,14 @@ class Toolchain:
             output_path = target_dir / relative
             output_path.parent.mkdir(parents=True, exist_ok=True)
 
-            compiled = self.compiler.compile_file(source_path, target=target, optimize=opts.optimize)
             if target == "bytecode":
+                compiled = self.compiler.compile_file(source_path, target=target, optimize=opts.optimize)
                 assert isinstance(compiled, (bytes, bytearray))
                 data = bytes(compiled)
                 output_path.write_bytes(data)
                 size = len(data)
             else:
-                assert isinstance(compiled, str)
-                text = compiled
+                text = self._compile_text(source_path, target, optimize=opts.optimize)
                 if opts.encrypt:
                     text = self.compiler.encrypt_output(text, opts.encrypt)
                 output_path.write_text(text, encoding="utf-8")
@@ -129,12 +133,23 @@ class Toolchain:
     # Runtime helpers
     def run(self, source: Path, *, optimize: bool = True, argv: Iterable[str] | None = None) -> None:
         source_path = self._resolve_source(source)
-        code = self.compiler.compile_file(source_path, target="python", optimize=optimize)
-        assert isinstance(code, str)
+        code = self._compile_text(source_path, "python", optimize=optimize)
         self.runtime.execute_python(code, argv=list(argv or []))
 
     # ------------------------------------------------------------------
     # Internal helpers
+    def _compile_text(self, source_path: Path, target: str, *, optimize: bool) -> str:
+        # Only the python target routes through libtrifc: its native output is
+        # parity-checked against codegen.py, whereas the native javascript
+        # generator targets a different runtime module layout than the one
+        # this toolchain ships.
+        if self.native_compiler is not None and target == "python":
+            source = source_path.read_text(encoding="utf-8")
+            return self.native_compiler.compile_source(source, target=target, optimize=optimize)
+        compiled = self.compiler.compile_file(source_path, target=target, optimize=optimize)
+        assert isinstance(compiled, str)
+        return compiled
+
     def _normalize_targets(self, targets: Sequence[str]) -> List[str]:
         if not targets:
             return ["python"]